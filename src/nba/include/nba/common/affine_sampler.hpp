@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/**
+ * Samples a span of pixels from an affine (BG mode 1 and 2) background.
+ *
+ * (x, y) is the 20.8 fixed-point texture coordinate of the first pixel and (dx, dy) is added for every following pixel.
+ * The 8-bit palette index of each pixel is written to indices[0] to indices[count - 1].
+ * Without wraparound, pixels outside of the background are transparent and do not access VRAM.
+ *
+ * The texture coordinates are computed in batches ahead of the tile map and tile data lookups,
+ * so that the coordinate math can be vectorized independently of the (inherently scalar) VRAM lookups.
+ */
+inline void SampleAffineBackground(
+  u8 const* vram,
+  u32 map_base,
+  u32 tile_base,
+  int log_size,
+  bool wraparound,
+  s32 x,
+  s32 y,
+  s32 dx,
+  s32 dy,
+  int count,
+  u8* indices
+) {
+  static constexpr int k_batch_size = 32;
+
+  const s32 size = 128 << log_size;
+  const s32 mask = size - 1;
+
+  s32 batch_x[k_batch_size];
+  s32 batch_y[k_batch_size];
+
+  for(int i = 0; i < count; i += k_batch_size) {
+    const int length = std::min(count - i, k_batch_size);
+
+    for(int j = 0; j < length; j++) {
+      batch_x[j] = (x + j * dx) >> 8;
+      batch_y[j] = (y + j * dy) >> 8;
+    }
+
+    for(int j = 0; j < length; j++) {
+      s32 u = batch_x[j];
+      s32 v = batch_y[j];
+
+      if(wraparound) {
+        u &= mask;
+        v &= mask;
+      } else if(((u | v) & -size) != 0) {
+        indices[i + j] = 0U;
+        continue;
+      }
+
+      const u16 map_address = map_base + ((v >> 3) << (4 + log_size)) + (u >> 3);
+      const u8 tile = vram[map_address];
+
+      indices[i + j] = vram[tile_base + (tile << 6) + ((v & 7) << 3) + (u & 7)];
+    }
+
+    x += length * dx;
+    y += length * dy;
+  }
+}
+
+} // namespace nba
@@ -23,13 +23,27 @@ struct Resampler : WriteStream<T> {
   Resampler(std::shared_ptr<WriteStream<T>> output) : output(output) {}
   
   virtual void SetSampleRates(float samplerate_in, float samplerate_out) {
-    resample_phase_shift = samplerate_in / samplerate_out;
+    resample_ratio = samplerate_in / samplerate_out;
+    resample_phase_shift = resample_ratio * rate_adjustment;
+  }
+
+  /**
+   * Scales the ratio of input to output samples by a factor close to one,
+   * without reconfiguring the resampler. Used for dynamic rate control.
+   */
+  void SetRateAdjustment(float factor) {
+    rate_adjustment = factor;
+    resample_phase_shift = resample_ratio * rate_adjustment;
   }
 
 protected:
   std::shared_ptr<WriteStream<T>> output;
   
+  float resample_ratio = 1;
   float resample_phase_shift = 1;
+
+private:
+  float rate_adjustment = 1;
 };
 
 template <typename T>
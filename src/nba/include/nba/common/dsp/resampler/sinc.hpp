@@ -7,87 +7,126 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <nba/common/dsp/resampler.hpp>
-#include <nba/common/dsp/ring_buffer.hpp>
 
 namespace nba {
 
+/**
+ * Polyphase windowed-sinc resampler.
+ *
+ * The kernel is stored phase-major, so that the coefficients for one output sample are contiguous.
+ * The input history is mirrored (every sample is stored twice, `points` samples apart),
+ * so that the last `points` input samples are always available as one contiguous window.
+ * Kernels only depend on the cutoff frequency and are shared between all resamplers with the same number of points.
+ */
 template<typename T, int points>
 struct SincResampler : Resampler<T> {
   static_assert((points % 4) == 0, "SincResampler<T, points>: points must be divisible by four.");
 
-  SincResampler(std::shared_ptr<WriteStream<T>> output) 
+  SincResampler(std::shared_ptr<WriteStream<T>> output)
       : Resampler<T>(output) {
     SetSampleRates(1, 1);
-
-    for(int i = 0; i < points - 1; i++) {
-      taps.Write({});
-    }
   }
-  
+
   void SetSampleRates(float samplerate_in, float samplerate_out) final {
     Resampler<T>::SetSampleRates(samplerate_in, samplerate_out);
-    
-    float kernelSum = 0.0;
+
     float cutoff = 0.9;
-    
-    if(this->resample_phase_shift > 1.0) {
-      cutoff /= this->resample_phase_shift;
+
+    // The cutoff ignores the rate adjustment, which is too small to matter for the filter.
+    if(this->resample_ratio > 1.0) {
+      cutoff /= this->resample_ratio;
+    }
+
+    kernel = GetKernel(cutoff);
+  }
+
+  void Write(T const& input) final {
+    history[head] = input;
+    history[head + points] = input;
+
+    if(++head == points) {
+      head = 0;
+    }
+
+    // Oldest to newest input sample
+    T const* window = &history[head];
+
+    while(resample_phase < 1.0) {
+      const int phase = (int)(resample_phase * s_lut_resolution);
+
+      this->output->Write(DotProduct(window, &kernel[phase * points]));
+
+      resample_phase += this->resample_phase_shift;
+    }
+
+    resample_phase = resample_phase - 1.0;
+  }
+
+private:
+  static constexpr int s_lut_resolution = 512;
+  static constexpr int s_lanes = 4;
+
+  static auto DotProduct(T const* window, float const* coefficients) -> T {
+    // Independent partial sums allow the compiler to vectorize the loop without reordering floating-point additions.
+    T sum[s_lanes] {};
+
+    for(int n = 0; n < points; n += s_lanes) {
+      for(int lane = 0; lane < s_lanes; lane++) {
+        sum[lane] += window[n + lane] * coefficients[n + lane];
+      }
+    }
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+
+  static auto GetKernel(float cutoff) -> std::shared_ptr<float[]> {
+    static std::mutex mutex;
+    static std::map<float, std::shared_ptr<float[]>> cache;
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    auto& kernel = cache[cutoff];
+
+    if(!kernel) {
+      kernel = CreateKernel(cutoff);
     }
+    return kernel;
+  }
+
+  static auto CreateKernel(float cutoff) -> std::shared_ptr<float[]> {
+    auto kernel = std::shared_ptr<float[]>(new float[points * s_lut_resolution]);
+
+    double kernelSum = 0.0;
 
     for(int n = 0; n < points; n++) {
       for(int m = 0; m < s_lut_resolution; m++) {
         double t  = m/double(s_lut_resolution);
         double x1 = M_PI * (t - n + points/2) + 1e-6;
-        double x2 = 2 * M_PI * (n + t)/points; 
+        double x2 = 2 * M_PI * (n + t)/points;
         double sinc = std::sin(cutoff * x1)/x1;
         double blackman = 0.42 - 0.49 * std::cos(x2) + 0.076 * std::cos(2 * x2);
-        
-        lut[n * s_lut_resolution + m] = sinc * blackman;
+
+        kernel[m * points + n] = sinc * blackman;
         kernelSum += sinc * blackman;
       }
     }
-    
-    kernelSum /= s_lut_resolution;
-    
-    for(int i = 0; i < points * s_lut_resolution; i++) {
-      lut[i] /= kernelSum;
-    }
-  }
 
-  void Write(T const& input) final {
-    taps.Write(input);
-
-    while(resample_phase < 1.0) { 
-      T sample = {};
-
-      int x = (int)(resample_phase * s_lut_resolution);
-      
-      for(int n = 0; n < points; n += 4) {        
-        sample += taps.Peek(n + 0) * lut[x + 0 * s_lut_resolution];
-        sample += taps.Peek(n + 1) * lut[x + 1 * s_lut_resolution]; 
-        sample += taps.Peek(n + 2) * lut[x + 2 * s_lut_resolution]; 
-        sample += taps.Peek(n + 3) * lut[x + 3 * s_lut_resolution];
-        
-        x += 4 * s_lut_resolution;
-      }
-
-      this->output->Write(sample);
+    kernelSum /= s_lut_resolution;
 
-      resample_phase += this->resample_phase_shift;
+    for(int i = 0; i < points * s_lut_resolution; i++) {
+      kernel[i] /= kernelSum;
     }
 
-    taps.Read();
-
-    resample_phase = resample_phase - 1.0;
+    return kernel;
   }
-  
-private:
-  static constexpr int s_lut_resolution = 512;
 
-  double lut[points * s_lut_resolution];
+  std::shared_ptr<float[]> kernel;
   float resample_phase = 0;
-  RingBuffer<T> taps { points };
+  int head = 0;
+  T history[points * 2] {};
 };
 
 template <typename T, int points>
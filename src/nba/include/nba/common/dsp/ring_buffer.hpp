@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <nba/common/dsp/stereo.hpp>
 #include <nba/common/dsp/stream.hpp>
@@ -23,6 +24,7 @@ struct RingBuffer : Stream<T> {
   }
 
   auto Available() -> int { return count; }
+  auto Capacity() -> int { return length; }
 
   void Reset() {
     rd_ptr = 0;
@@ -46,6 +48,20 @@ struct RingBuffer : Stream<T> {
     return value;
   }
 
+  // Reads up to `count` values in at most two contiguous copies and returns the number of values read.
+  auto Read(T* destination, int count) -> int {
+    count = std::min(count, this->count);
+
+    const int count_until_wrap = std::min(count, length - rd_ptr);
+
+    std::copy_n(&data[rd_ptr], count_until_wrap, destination);
+    std::copy_n(&data[0], count - count_until_wrap, destination + count_until_wrap);
+
+    rd_ptr = (rd_ptr + count) % length;
+    this->count -= count;
+    return count;
+  }
+
   void Write(T const& value) {
     if(blocking && count == length) {
       return;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <nba/integer.hpp>
+#include <utility>
+
+namespace nba {
+
+/**
+ * Bounded lock-free queue for any number of producer threads and a single consumer thread.
+ *
+ * Every slot carries a sequence number which tells whether it is free for the producer
+ * that claimed its position or holds a value for the consumer.
+ * The consumer checks for pending values with a single atomic load, without taking any locks.
+ */
+template<typename T, int capacity>
+struct MPSCQueue {
+  static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "MPSCQueue<T, capacity>: capacity must be a power of two.");
+
+  MPSCQueue() {
+    for(int i = 0; i < capacity; i++) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Producer: try to enqueue a value. Returns false if the queue is full.
+  bool TryPush(T const& value) {
+    u32 position = enqueue_position.load(std::memory_order_relaxed);
+
+    while(true) {
+      auto& slot = slots[position & k_index_mask];
+      const s32 difference = (s32)(slot.sequence.load(std::memory_order_acquire) - position);
+
+      if(difference == 0) {
+        // The slot is free: try to claim the position.
+        if(enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          slot.value = value;
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if(difference < 0) {
+        // The consumer did not free the slot yet: the queue is full.
+        return false;
+      } else {
+        // Another producer claimed the position first.
+        position = enqueue_position.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Consumer: try to dequeue a value. Returns false if the queue is empty.
+  bool TryPop(T& value) {
+    auto& slot = slots[dequeue_position & k_index_mask];
+
+    if(slot.sequence.load(std::memory_order_acquire) != dequeue_position + 1) {
+      return false;
+    }
+
+    value = std::move(slot.value);
+    slot.sequence.store(dequeue_position + capacity, std::memory_order_release);
+    dequeue_position++;
+    return true;
+  }
+
+private:
+  static constexpr u32 k_index_mask = capacity - 1;
+
+  struct Slot {
+    std::atomic<u32> sequence;
+    T value;
+  };
+
+  Slot slots[capacity];
+
+  alignas(64) std::atomic<u32> enqueue_position = 0;
+  alignas(64) u32 dequeue_position = 0; // owned by the consumer
+};
+
+} // namespace nba
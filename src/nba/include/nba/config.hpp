@@ -18,6 +18,9 @@ namespace nba {
 struct Config {
   bool skip_bios = false;
 
+  // Number of frames which are not output after each composed frame.
+  int frameskip = 0;
+
   enum class BackupType {
     Detect,
     None,
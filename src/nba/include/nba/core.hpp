@@ -13,6 +13,7 @@
 #include <nba/rom/rom.hpp>
 #include <nba/config.hpp>
 #include <nba/integer.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <nba/save_state.hpp>
 #include <nba/scheduler.hpp>
 #include <vector>
@@ -47,6 +48,7 @@ struct CoreBase {
   virtual void LoadState(SaveState const& state) = 0;
   virtual void CopyState(SaveState& state) = 0;
   virtual void SetKeyStatus(Key key, bool pressed) = 0;
+  virtual void SetFrameSkip(int frameskip) = 0;
   virtual void Run(int cycles) = 0;
 
   virtual auto GetROM() -> ROM& = 0;
@@ -60,6 +62,9 @@ struct CoreBase {
   virtual auto GetBGHOFS(int id) -> u16 = 0;
   virtual auto GetBGVOFS(int id) -> u16 = 0;
 
+  // Snapshots of the PPU state, which unlike the accessors above may be used from any thread.
+  virtual auto GetPPUSnapshotMailbox() -> PPUSnapshotMailbox& = 0;
+
   virtual core::Scheduler& GetScheduler() = 0;
 
   void RunForOneFrame() {
@@ -10,17 +10,46 @@
 #include <nba/integer.hpp>
 
 namespace nba {
+
+enum class SampleFormat {
+  S16,
+  F32
+};
+
+/**
+ * What the callback fills the stream with when the emulator did not buffer enough samples.
+ * Repeating the buffered samples hides short dropouts during real-time playback,
+ * but devices that record the audio need the stream to only contain the emulator's output.
+ */
+enum class UnderrunMode {
+  Repeat,
+  Silence
+};
   
 struct AudioDevice {
   virtual ~AudioDevice() = default;
 
   typedef void (*Callback)(void* userdata, s16* stream, int byte_len);
 
+  /**
+   * Number of blocks (of GetBlockSize() samples) that the emulator buffers for the callback.
+   * Dynamic rate control keeps the buffer about half full.
+   */
+  static constexpr int k_buffered_blocks = 3;
+
   virtual auto GetSampleRate() -> int = 0;
   virtual auto GetBlockSize() -> int = 0;
   virtual bool Open(void* userdata, Callback callback) = 0;
   virtual void SetPause(bool value) = 0;
   virtual void Close() = 0;
+
+  /**
+   * Sample format of the stream that is passed to the callback.
+   * For F32 the stream holds interleaved float samples and has to be accessed as such.
+   */
+  virtual auto GetSampleFormat() -> SampleFormat { return SampleFormat::S16; }
+
+  virtual auto GetUnderrunMode() -> UnderrunMode { return UnderrunMode::Repeat; }
 };
 
 struct NullAudioDevice : AudioDevice {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/**
+ * Lock-free triple buffer for handing complete frames from the emulator thread (producer)
+ * to the presenting thread (consumer) without copying or tearing.
+ *
+ * The producer composes into the write buffer and publishes it once the frame is complete.
+ * Publishing never blocks: if the consumer did not pick up the previous frame yet, that frame is dropped.
+ * The consumer always acquires the newest published frame and owns it until it acquires the next one.
+ */
+struct FrameMailbox {
+  static constexpr int k_width  = 240;
+  static constexpr int k_height = 160;
+
+  FrameMailbox() {
+    for(auto& buffer : buffers) {
+      for(auto& pixel : buffer) pixel = 0xFF000000;
+    }
+  }
+
+  // Producer: get the buffer that the next frame should be composed into.
+  auto GetWriteBuffer() -> u32* {
+    return buffers[back];
+  }
+
+  // Producer: publish the write buffer and get a new buffer to compose the next frame into.
+  void Publish() {
+    back = middle.exchange(back | k_new_frame_flag, std::memory_order_acq_rel) & k_index_mask;
+  }
+
+  // Consumer: check if a frame was published since the last call to Acquire().
+  bool HasNewFrame() const {
+    return middle.load(std::memory_order_acquire) & k_new_frame_flag;
+  }
+
+  // Consumer: get the newest published frame. The buffer remains valid until the next call to Acquire().
+  auto Acquire() -> u32* {
+    if(HasNewFrame()) {
+      front = middle.exchange(front, std::memory_order_acq_rel) & k_index_mask;
+    }
+    return buffers[front];
+  }
+
+private:
+  static constexpr int k_index_mask = 3;
+  static constexpr int k_new_frame_flag = 4;
+
+  u32 buffers[3][k_width * k_height];
+
+  int back = 0;  // owned by the producer
+  int front = 1; // owned by the consumer
+  alignas(64) std::atomic_int middle = 2;
+};
+
+} // namespace nba
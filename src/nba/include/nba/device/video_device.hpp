@@ -7,18 +7,71 @@
 
 #pragma once
 
+#include <nba/device/frame_mailbox.hpp>
 #include <nba/integer.hpp>
 
 namespace nba {
 
+enum class PixelFormat {
+  // 32-bit 0xAARRGGBB, with alpha always set to 0xFF.
+  ARGB8888,
+  // 16-bit 0bxBBBBBGGGGGRRRRR, the native GBA format (red in the low bits).
+  BGR555,
+  // 16-bit 0bRRRRRGGGGGGBBBBB (red in the high bits).
+  RGB565
+};
+
 struct VideoDevice {
   virtual ~VideoDevice() = default;
 
+  /**
+   * Called once a frame is complete. The buffer is only guaranteed to be valid during the call.
+   * Devices which present frames on a different thread should provide a frame mailbox instead.
+   * For 16-bit pixel formats the buffer holds tightly packed u16 pixels and has to be accessed as such.
+   */
   virtual void Draw(u32* buffer) = 0;
+
+  /**
+   * Called instead of Draw() if the frame is identical to the previously drawn frame.
+   * For devices with a frame mailbox, no new frame is published in this case.
+   * By default the frame is drawn regardless.
+   */
+  virtual void DrawUnchanged(u32* buffer) { Draw(buffer); }
+
+  /**
+   * Pixel format of the frames passed to Draw().
+   * The pixel format is queried once per frame, before composition of the frame begins.
+   */
+  virtual auto GetPixelFormat() -> PixelFormat { return PixelFormat::ARGB8888; }
+
+  /**
+   * Optional mailbox which the PPU composes frames into directly.
+   * Frames are published to the mailbox right before Draw() is called.
+   */
+  virtual auto GetFrameMailbox() -> FrameMailbox* { return nullptr; }
+
+  /**
+   * Whether the device consumes frames at all. This is queried once per frame.
+   * If false, the PPU only emulates the timing of the frame (like a skipped frame)
+   * and neither composes pixels nor calls Draw().
+   */
+  virtual bool WantsFrames() { return true; }
 };
 
+/**
+ * Video device which discards all frames.
+ * By default frames are still composed, so that the emulation behaves exactly like with any other video device.
+ * Headless hosts may opt into skipping the composition of all frames instead.
+ */
 struct NullVideoDevice : VideoDevice {
+  NullVideoDevice(bool skip_frames = false) : skip_frames(skip_frames) {}
+
   void Draw(u32* buffer) final { }
+
+  bool WantsFrames() final { return !skip_frames; }
+
+private:
+  bool skip_frames;
 };
 
 } // namespace nba
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/**
+ * Copy of the PPU memories and of the PPU registers that debugging tools are interested in.
+ * Snapshots are taken by the emulator thread at the start of V-blank.
+ */
+struct PPUSnapshot {
+  static constexpr u32 k_block_size = 512;
+
+  u8 pram[0x00400];
+  u8 oam [0x00400];
+  u8 vram[0x18000];
+
+  u16 dispcnt;
+  u16 bgcnt[4];
+  u16 bghofs[4];
+  u16 bgvofs[4];
+
+  /**
+   * Snapshots are numbered in the order that they were taken in, starting at one.
+   * For each block of the memories, the number of the snapshot in which the block last changed is kept,
+   * so that consumers can tell which parts of the memories changed since a snapshot that they've seen before.
+   */
+  u64 sequence;
+  u64 pram_version[sizeof(pram) / k_block_size];
+  u64 oam_version [sizeof(oam)  / k_block_size];
+  u64 vram_version[sizeof(vram) / k_block_size];
+
+  bool PRAMChangedSince(u64 since, u32 address, u32 size) const {
+    return ChangedSince(pram_version, sizeof(pram), since, address, size);
+  }
+
+  bool OAMChangedSince(u64 since, u32 address, u32 size) const {
+    return ChangedSince(oam_version, sizeof(oam), since, address, size);
+  }
+
+  bool VRAMChangedSince(u64 since, u32 address, u32 size) const {
+    return ChangedSince(vram_version, sizeof(vram), since, address, size);
+  }
+
+private:
+  static bool ChangedSince(u64 const* versions, u32 memory_size, u64 since, u32 address, u32 size) {
+    const u32 address_end = std::min(address + size, memory_size);
+
+    for(u32 block = address / k_block_size; block * k_block_size < address_end; block++) {
+      if(versions[block] > since) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * Lock-free triple buffer for handing PPU snapshots from the emulator thread (producer)
+ * to debugging tools (consumer), which works just like the FrameMailbox.
+ *
+ * Snapshots are only taken while at least one consumer is subscribed, so that the emulation does not pay for them otherwise.
+ * The consumer side may be shared by multiple widgets if they all live on the same thread.
+ * Because every call to Acquire() may swap out the snapshot, a snapshot must not be held on to past the current call.
+ */
+struct PPUSnapshotMailbox {
+  // Consumer: request snapshots to be taken. Each call must be balanced by a call to Unsubscribe().
+  void Subscribe() {
+    subscribers.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Unsubscribe() {
+    subscribers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Producer: check if snapshots should be taken at all.
+  bool HasSubscribers() const {
+    return subscribers.load(std::memory_order_relaxed) > 0;
+  }
+
+  /**
+   * Producer: get the snapshot that should be updated next.
+   * It holds an older snapshot, so only the parts which changed since then need to be copied.
+   */
+  auto GetWriteBuffer() -> PPUSnapshot& {
+    return snapshots[back];
+  }
+
+  // Producer: get the most recently published snapshot. The consumer may be reading it, so it must not be modified.
+  auto GetLatestSnapshot() const -> PPUSnapshot const& {
+    return snapshots[latest];
+  }
+
+  // Producer: publish the write buffer.
+  void Publish() {
+    latest = back;
+    back = middle.exchange(back | k_new_snapshot_flag, std::memory_order_acq_rel) & k_index_mask;
+  }
+
+  // Consumer: check if a snapshot was published since the last call to Acquire().
+  bool HasNewSnapshot() const {
+    return middle.load(std::memory_order_acquire) & k_new_snapshot_flag;
+  }
+
+  // Consumer: get the newest published snapshot. The snapshot remains valid until the next call to Acquire().
+  auto Acquire() -> PPUSnapshot const& {
+    if(HasNewSnapshot()) {
+      front = middle.exchange(front, std::memory_order_acq_rel) & k_index_mask;
+    }
+    return snapshots[front];
+  }
+
+private:
+  static constexpr int k_index_mask = 3;
+  static constexpr int k_new_snapshot_flag = 4;
+
+  PPUSnapshot snapshots[3] {};
+
+  int back = 0;   // owned by the producer
+  int latest = 2; // owned by the producer
+  int front = 1;  // owned by the consumer
+  alignas(64) std::atomic_int middle = 2;
+  alignas(64) std::atomic_int subscribers = 0;
+};
+
+} // namespace nba
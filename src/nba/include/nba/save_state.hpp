@@ -16,7 +16,7 @@ namespace nba {
 
 struct SaveState {
   static constexpr u32 kMagicNumber = 0x5353424E; // NBSS
-  static constexpr u32 kCurrentVersion = 10;
+  static constexpr u32 kCurrentVersion = 13;
 
   u32 magic;
   u32 version;
@@ -160,7 +160,8 @@ struct SaveState {
           u8 step;
         } sweep;
 
-        u64 event_uid;
+        bool stepping;
+        u64 timestamp_next_step;
       };
 
       struct QuadChannel : PSG {
@@ -204,6 +205,8 @@ struct SaveState {
     } fifo[2];
 
     u8 resolution_old;
+    u64 fifo_refill_event_uid;
+    u64 mixer_event_uid;
   } apu;
 
   struct Timer {
@@ -216,6 +219,7 @@ struct SaveState {
       u16 control;
     } pending;
 
+    u16 prescaler_phase;
     u64 event_uid;
   } timer[4];
 
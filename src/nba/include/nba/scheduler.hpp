@@ -44,10 +44,7 @@ struct Scheduler {
     // APU
     APU_mixer,
     APU_sequencer,
-    APU_PSG1_generate,
-    APU_PSG2_generate,
-    APU_PSG3_generate,
-    APU_PSG4_generate,
+    APU_fifo_refill,
 
     // IRQ controller
     IRQ_write_io,
@@ -116,6 +116,10 @@ auto Bus::Read(u32 address, int access) -> T {
     case 0x04: {
       Step(1);
       address = Align<T>(address);
+      // The currently playing wave RAM bank depends on the progress of the wave channel.
+      if(address >= SOUND3CNT_L && address < FIFO_A) {
+        hw.apu.Sync();
+      }
       if constexpr(std::is_same_v<T,  u8>) return hw.ReadByte(address);
       if constexpr(std::is_same_v<T, u16>) return hw.ReadHalf(address);
       if constexpr(std::is_same_v<T, u32>) return hw.ReadWord(address);
@@ -213,9 +217,16 @@ void Bus::Write(u32 address, int access, T value) {
       if(address >= DISPCNT && address <= BLDY) {
         hw.ppu.Sync();
       }
+      if(address >= SOUND1CNT_L && address < DMA0SAD) {
+        hw.apu.Sync();
+      }
       if constexpr(std::is_same_v<T,  u8>) hw.WriteByte(address, value);
       if constexpr(std::is_same_v<T, u16>) hw.WriteHalf(address, value);
       if constexpr(std::is_same_v<T, u32>) hw.WriteWord(address, value);
+      // Writes to the FIFOs and to SOUNDCNT change when the FIFOs will request the next DMA.
+      if((address >= SOUNDCNT_H && address < SOUNDBIAS) || (address >= FIFO_A && address < DMA0SAD)) {
+        hw.apu.UpdateFIFORefills();
+      }
       break;
     }
     // PRAM (palette RAM)
@@ -141,6 +141,7 @@ struct Bus {
     for(int i = 0; i < cycles; i++) {
       do {
         Step(1);
+        if(hw.ppu.IsIdleOrForcedBlank()) break;
         hw.ppu.Sync();
       } while(hw.ppu.DidAccessPRAM());
     }
@@ -153,6 +154,7 @@ struct Bus {
     if constexpr (!std::is_same_v<T, u32>) {
       do {
         Step(1);
+        if(hw.ppu.IsIdleOrForcedBlank()) break;
         hw.ppu.Sync();
       } while(hw.ppu.DidAccessPRAM());
 
@@ -175,6 +177,7 @@ struct Bus {
       for(int i = 0; i < cycles; i++) {
         do {
           Step(1);
+          if(hw.ppu.IsIdle()) break;
           hw.ppu.Sync();
         } while(hw.ppu.DidAccessVRAM_OBJ());
       }
@@ -184,6 +187,7 @@ struct Bus {
       for(int i = 0; i < cycles; i++) {
         do {
           Step(1);
+          if(hw.ppu.IsIdleOrForcedBlank()) break;
           hw.ppu.Sync();
         } while(hw.ppu.DidAccessVRAM_BG());
       }
@@ -203,6 +207,7 @@ struct Bus {
         // TODO: de-duplicate this code (see ReadVRAM):
         do {
           Step(1);
+          if(hw.ppu.IsIdle()) break;
           hw.ppu.Sync();
         } while(hw.ppu.DidAccessVRAM_OBJ());
 
@@ -211,6 +216,7 @@ struct Bus {
         // TODO: de-duplicate this code (see ReadVRAM):
         do {
           Step(1);
+          if(hw.ppu.IsIdleOrForcedBlank()) break;
           hw.ppu.Sync();
         } while(hw.ppu.DidAccessVRAM_BG());
 
@@ -226,6 +232,7 @@ struct Bus {
   auto ALWAYS_INLINE ReadOAM(u32 address) noexcept -> T {
     do {
       Step(1);
+      if(hw.ppu.IsIdle()) break;
       hw.ppu.Sync();
     } while(hw.ppu.DidAccessOAM());
 
@@ -236,6 +243,7 @@ struct Bus {
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
     do {
       Step(1);
+      if(hw.ppu.IsIdle()) break;
       hw.ppu.Sync();
     } while(hw.ppu.DidAccessOAM());
 
@@ -46,6 +46,7 @@ void Core::Reset() {
   if(config->audio.mp2k_hle_enable) {
     apu.GetMP2K().UseCubicFilter() = config->audio.mp2k_hle_cubic;
     apu.GetMP2K().ForceReverb() = config->audio.mp2k_hle_force_reverb;
+    apu.GetMP2K().SetupWaveCache();
     hle_audio_hook = SearchSoundMainRAM();
     if(hle_audio_hook != 0xFFFFFFFF) {
       Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", hle_audio_hook);
@@ -75,6 +76,10 @@ void Core::SetKeyStatus(Key key, bool pressed) {
   keypad.SetKeyStatus(key, pressed);
 }
 
+void Core::SetFrameSkip(int frameskip) {
+  ppu.SetFrameSkip(frameskip);
+}
+
 void Core::Run(int cycles) {
   using HaltControl = Bus::Hardware::HaltControl;
 
@@ -87,6 +92,7 @@ void Core::Run(int cycles) {
         const auto sound_info = bus.GetHostAddress<MP2K::SoundInfo>(sound_info_addr);
 
         if(sound_info != nullptr) {
+          apu.Sync();
           apu.GetMP2K().SoundMainRAM(*sound_info);
         }
       }
@@ -188,6 +194,10 @@ auto Core::GetBGVOFS(int id) -> u16 {
   return ppu.mmio.bgvofs[id];
 }
 
+auto Core::GetPPUSnapshotMailbox() -> PPUSnapshotMailbox& {
+  return ppu.GetSnapshotMailbox();
+}
+
 Scheduler& Core::GetScheduler() {
   return scheduler;
 }
@@ -31,6 +31,7 @@ struct Core final : CoreBase {
   void LoadState(SaveState const& state) override;
   void CopyState(SaveState& state) override;
   void SetKeyStatus(Key key, bool pressed) override;
+  void SetFrameSkip(int frameskip) override;
   void Run(int cycles) override;
 
   auto GetROM() -> ROM& override;
@@ -42,6 +43,7 @@ struct Core final : CoreBase {
   auto PeekWordIO(u32 address) -> u32 override;
   auto GetBGHOFS(int id) -> u16 override;
   auto GetBGVOFS(int id) -> u16 override;
+  auto GetPPUSnapshotMailbox() -> PPUSnapshotMailbox& override;
 
   Scheduler& GetScheduler() override;
 
@@ -28,9 +28,15 @@ APU::APU(
     , config(config) {
   scheduler.Register(Scheduler::EventClass::APU_mixer, this, &APU::StepMixer);
   scheduler.Register(Scheduler::EventClass::APU_sequencer, this, &APU::StepSequencer);
+  scheduler.Register(Scheduler::EventClass::APU_fifo_refill, this, &APU::OnFIFORefillDue);
 }
 
 APU::~APU() {
+  // Hand the samples that were mixed last to the audio device, which may still read them when it is closed.
+  if(resampler) {
+    FlushMixer();
+  }
+
   config->audio_dev->Close();
 }
 
@@ -45,21 +51,51 @@ void APU::Reset() {
   mmio.bias.Reset();
   fifo_pipe[0] = {};
   fifo_pipe[1] = {};
+  lazy_overflows[0] = {};
+  lazy_overflows[1] = {};
+  fifo_refill_event = nullptr;
 
   resolution_old = 0;
-  scheduler.Add(mmio.bias.GetSampleInterval(), Scheduler::EventClass::APU_mixer);
   scheduler.Add(BaseChannel::s_cycles_per_step, Scheduler::EventClass::APU_sequencer);
 
   mp2k.Reset();
   mp2k_read_index = {};
 
   auto audio_dev = config->audio_dev;
+
+  if(resampler) {
+    FlushMixer();
+  }
+
   audio_dev->Close();
   audio_dev->Open(this, (AudioDevice::Callback)AudioCallback);
 
+  /**
+   * Nobody listens to the NullAudioDevice, so we do not mix any samples for it.
+   * The sound hardware as seen by the emulated CPU (FIFOs, PSG sequencer and registers) behaves the same.
+   */
+  audio_enabled = dynamic_cast<NullAudioDevice*>(audio_dev.get()) == nullptr;
+
+  mixer.block_size = 0;
+
+  if(!audio_enabled) {
+    mixer.timestamp_next_sample = ~0ULL;
+    mixer.event = nullptr;
+    buffer = nullptr;
+    resampler = nullptr;
+    return;
+  }
+
+  mixer.timestamp_next_sample = scheduler.GetTimestampNow() + mmio.bias.GetSampleInterval();
+  mixer.event = scheduler.Add(Mixer::k_block_cycles, Scheduler::EventClass::APU_mixer);
+
   using Interpolation = Config::Audio::Interpolation;
 
-  buffer = std::make_shared<StereoRingBuffer<float>>(audio_dev->GetBlockSize() * 4, true);
+  /**
+   * Dynamic rate control keeps the buffer about half full,
+   * so a few blocks are enough to absorb the jitter of the audio callback.
+   */
+  buffer = std::make_shared<StereoRingBuffer<float>>(audio_dev->GetBlockSize() * AudioDevice::k_buffered_blocks, true);
 
   switch(config->audio.interpolation) {
     case Interpolation::Cosine:
@@ -86,12 +122,104 @@ void APU::Reset() {
 }
 
 void APU::OnTimerOverflow(int timer_id, int times) {
-  auto const& soundcnt = mmio.soundcnt;
-
-  if(!soundcnt.master_enable) {
+  if(!mmio.soundcnt.master_enable) {
     return;
   }
 
+  Sync();
+
+  while(times-- > 0) {
+    FeedFIFOs(timer_id);
+  }
+}
+
+void APU::StartLazyTimerOverflows(int timer_id, u64 timestamp_next, u64 interval) {
+  Sync();
+
+  lazy_overflows[timer_id] = { timestamp_next, interval };
+
+  UpdateFIFORefills();
+}
+
+void APU::StopLazyTimerOverflows(int timer_id) {
+  Sync();
+
+  lazy_overflows[timer_id] = {};
+
+  UpdateFIFORefills();
+}
+
+void APU::UpdateFIFORefills() {
+  u64 timestamp = ~0ULL;
+
+  /**
+   * Lazy overflows are applied whenever the APU is synced, but the DMA request of a FIFO that runs low
+   * must happen on time. Schedule an event for the first overflow that will request a DMA.
+   */
+  if(mmio.soundcnt.master_enable) {
+    for(int fifo_id = 0; fifo_id < 2; fifo_id++) {
+      auto const& overflows = lazy_overflows[mmio.soundcnt.dma[fifo_id].timer_id];
+
+      if(overflows.timestamp_next != ~0ULL) {
+        const u64 overflows_until_request = GetOverflowsUntilDMARequest(fifo_id) - 1;
+
+        timestamp = std::min(timestamp, overflows.timestamp_next + overflows_until_request * overflows.interval);
+      }
+    }
+  }
+
+  if(fifo_refill_event) {
+    if(fifo_refill_event->timestamp == timestamp) {
+      return;
+    }
+
+    scheduler.Cancel(fifo_refill_event);
+    fifo_refill_event = nullptr;
+  }
+
+  if(timestamp != ~0ULL) {
+    fifo_refill_event = scheduler.Add(timestamp - scheduler.GetTimestampNow(), Scheduler::EventClass::APU_fifo_refill);
+  }
+}
+
+void APU::OnFIFORefillDue() {
+  fifo_refill_event = nullptr;
+
+  Sync();
+  UpdateFIFORefills();
+}
+
+void APU::RunLazyTimerOverflows(u64 timestamp) {
+  while(true) {
+    const int timer_id = lazy_overflows[0].timestamp_next <= lazy_overflows[1].timestamp_next ? 0 : 1;
+
+    auto& overflows = lazy_overflows[timer_id];
+
+    if(overflows.timestamp_next >= timestamp) {
+      break;
+    }
+
+    if(IsTimerFeedingFIFOs(timer_id)) {
+      FeedFIFOs(timer_id);
+      overflows.timestamp_next += overflows.interval;
+    } else {
+      // The overflows have no effect, so we can skip all of them at once.
+      const u64 count = (timestamp - 1 - overflows.timestamp_next) / overflows.interval + 1;
+
+      overflows.timestamp_next += count * overflows.interval;
+    }
+  }
+}
+
+bool APU::IsTimerFeedingFIFOs(int timer_id) {
+  auto const& soundcnt = mmio.soundcnt;
+
+  return soundcnt.master_enable && (soundcnt.dma[0].timer_id == timer_id || soundcnt.dma[1].timer_id == timer_id);
+}
+
+void APU::FeedFIFOs(int timer_id) {
+  auto const& soundcnt = mmio.soundcnt;
+
   constexpr DMA::Occasion occasion[2] = { DMA::Occasion::FIFO0, DMA::Occasion::FIFO1 };
 
   for(int fifo_id = 0; fifo_id < 2; fifo_id++) {
@@ -120,7 +248,33 @@ void APU::OnTimerOverflow(int timer_id, int times) {
   }
 }
 
+auto APU::GetOverflowsUntilDMARequest(int fifo_id) -> int {
+  int count = mmio.fifo[fifo_id].Count();
+  int pipe_size = fifo_pipe[fifo_id].size;
+  int overflows = 1;
+
+  // See FeedFIFOs(): each overflow requests a DMA if the FIFO is low and then consumes one byte.
+  while(count > 3) {
+    if(pipe_size == 0) {
+      count--;
+      pipe_size = 4;
+    }
+
+    pipe_size--;
+    overflows++;
+  }
+
+  return overflows;
+}
+
 void APU::StepMixer() {
+  Sync();
+  FlushMixer();
+
+  mixer.event = scheduler.Add(Mixer::k_block_cycles, Scheduler::EventClass::APU_mixer);
+}
+
+void APU::MixSample() {
   constexpr int psg_volume_tab[4] = { 1, 2, 4, 0 };
   constexpr int dma_volume_tab[2] = { 2, 4 };
 
@@ -129,10 +283,21 @@ void APU::StepMixer() {
 
   auto psg_volume = psg_volume_tab[psg.volume];
 
+  // The FIFO samples are latched by the timer overflows before this sample.
+  ApplyLazyTimerOverflows(mixer.timestamp_next_sample);
+
+  // The PSG channels catch up on their waveform steps up to this sample.
+  mmio.psg1.Sync(mixer.timestamp_next_sample);
+  mmio.psg2.Sync(mixer.timestamp_next_sample);
+  mmio.psg3.Sync(mixer.timestamp_next_sample);
+  mmio.psg4.Sync(mixer.timestamp_next_sample);
+
   if(mp2k.IsEngaged()) {
     StereoSample<float> sample { 0, 0 };
 
     if(resolution_old != 1) {
+      // Samples that were mixed at the previous sample rate must be resampled before the sample rate changes.
+      FlushMixer();
       resampler->SetSampleRates(65536, config->audio_dev->GetSampleRate());
       resolution_old = 1;
     }
@@ -161,17 +326,15 @@ void APU::StepMixer() {
 
     if(!mmio.soundcnt.master_enable) sample = {};
 
-    buffer_mutex.lock();
-    resampler->Write(sample);
-    buffer_mutex.unlock();
-
-    scheduler.Add(256 - (scheduler.GetTimestampNow() & 255), Scheduler::EventClass::APU_mixer);
+    mixer.block[mixer.block_size++] = sample;
+    mixer.timestamp_next_sample += 256 - (mixer.timestamp_next_sample & 255);
   } else {
     StereoSample<s16> sample { 0, 0 };
 
     auto& bias = mmio.bias;
 
     if(bias.resolution != resolution_old) {
+      FlushMixer();
       resampler->SetSampleRates(bias.GetSampleRate(), config->audio_dev->GetSampleRate());
       resolution_old = mmio.bias.resolution;
     }
@@ -199,18 +362,52 @@ void APU::StepMixer() {
 
     if(!mmio.soundcnt.master_enable) sample = {};
 
-    buffer_mutex.lock();
-    resampler->Write({ sample[0] / float(0x200), sample[1] / float(0x200) });
-    buffer_mutex.unlock();
+    mixer.block[mixer.block_size++] = { sample[0] / float(0x200), sample[1] / float(0x200) };
 
     const int sample_interval = mmio.bias.GetSampleInterval();
-    const int cycles = sample_interval - (scheduler.GetTimestampNow() & (sample_interval - 1));
 
-    scheduler.Add(cycles, Scheduler::EventClass::APU_mixer);
+    mixer.timestamp_next_sample += sample_interval - (mixer.timestamp_next_sample & (sample_interval - 1));
+  }
+
+  if(mixer.block_size == Mixer::k_max_block_size) {
+    FlushMixer();
   }
 }
 
+void APU::FlushMixer() {
+  if(mixer.block_size == 0) {
+    return;
+  }
+
+  buffer_mutex.lock();
+
+  /**
+   * Dynamic rate control: the emulator and the audio device are driven by different clocks.
+   * To keep the buffer from running dry or overflowing, we slightly lower the output rate
+   * when the buffer is more than half full and raise it when it is less than half full.
+   */
+  const float fill_level = (float)buffer->Available() / buffer->Capacity();
+
+  resampler->SetRateAdjustment(1.0f + Mixer::k_max_rate_deviation * (2.0f * fill_level - 1.0f));
+
+  for(int i = 0; i < mixer.block_size; i++) {
+    resampler->Write(mixer.block[i]);
+  }
+  buffer_mutex.unlock();
+
+  mixer.block_size = 0;
+}
+
 void APU::StepSequencer() {
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+
+  // The sequencer changes the volume, frequency and status of the PSG channels.
+  Sync();
+  mmio.psg1.Sync(timestamp_now);
+  mmio.psg2.Sync(timestamp_now);
+  mmio.psg3.Sync(timestamp_now);
+  mmio.psg4.Sync(timestamp_now);
+
   mmio.psg1.Tick();
   mmio.psg2.Tick();
   mmio.psg3.Tick();
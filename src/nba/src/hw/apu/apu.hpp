@@ -41,15 +41,43 @@ struct APU {
   auto GetMP2K() -> MP2K& { return mp2k; }
   void OnTimerOverflow(int timer_id, int times);
 
+  /**
+   * Timer overflows that have no side effects other than feeding the FIFOs are not scheduled as events.
+   * Instead the timer reports the timestamp of its next overflow and the overflow interval,
+   * and the FIFOs catch up on the overflows whenever the APU is synced.
+   */
+  void StartLazyTimerOverflows(int timer_id, u64 timestamp_next, u64 interval);
+  void StopLazyTimerOverflows(int timer_id);
+
+  /**
+   * Must be called after any state that affects when the FIFOs request a DMA was changed.
+   */
+  void UpdateFIFORefills();
+
+  /**
+   * Mixes all audio samples and applies all lazy timer overflows up to the current timestamp.
+   * If audio is disabled, no samples are due and only the timer overflows are applied.
+   * Must be called before any state that affects the mixer output is changed.
+   */
+  void Sync() {
+    const u64 timestamp_now = scheduler.GetTimestampNow();
+
+    while(mixer.timestamp_next_sample <= timestamp_now) {
+      MixSample();
+    }
+
+    ApplyLazyTimerOverflows(timestamp_now + 1);
+  }
+
   void LoadState(SaveState const& state);
   void CopyState(SaveState& state);
 
   struct MMIO {
     MMIO(Scheduler& scheduler)
-        : psg1(scheduler, Scheduler::EventClass::APU_PSG1_generate)
-        , psg2(scheduler, Scheduler::EventClass::APU_PSG2_generate)
+        : psg1(scheduler)
+        , psg2(scheduler)
         , psg3(scheduler)
-        , psg4(scheduler, bias) {
+        , psg4(scheduler) {
     }
 
     FIFO fifo[2];
@@ -77,8 +105,46 @@ private:
 
   void StepMixer();
   void StepSequencer();
+  void MixSample();
+  void FlushMixer();
+  void OnFIFORefillDue();
+
+  // Applies all lazy timer overflows before the given timestamp.
+  void ApplyLazyTimerOverflows(u64 timestamp) {
+    if(lazy_overflows[0].timestamp_next < timestamp || lazy_overflows[1].timestamp_next < timestamp) {
+      RunLazyTimerOverflows(timestamp);
+    }
+  }
+
+  void RunLazyTimerOverflows(u64 timestamp);
+  bool IsTimerFeedingFIFOs(int timer_id);
+  void FeedFIFOs(int timer_id);
+  auto GetOverflowsUntilDMARequest(int fifo_id) -> int;
+
+  /**
+   * Samples are mixed lazily whenever the mixer state is about to change (see Sync()),
+   * and are passed to the resampler in blocks, so that the buffer mutex is taken only once per block.
+   */
+  struct Mixer {
+    static constexpr int k_block_cycles = 16384;
+    static constexpr int k_max_block_size = 256;
+    static constexpr float k_max_rate_deviation = 0.005;
+
+    u64 timestamp_next_sample;
+    Scheduler::Event* event;
+    int block_size = 0;
+    StereoSample<float> block[k_max_block_size];
+  } mixer;
+
+  struct LazyOverflows {
+    u64 timestamp_next = ~0ULL;
+    u64 interval = 0;
+  } lazy_overflows[2];
+
+  Scheduler::Event* fifo_refill_event = nullptr;
 
   s8 latch[2];
+  bool audio_enabled = true;
 
   Scheduler& scheduler;
   DMA& dma;
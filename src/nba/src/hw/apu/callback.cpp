@@ -12,44 +12,94 @@
 
 namespace nba::core {
 
-void AudioCallback(APU* apu, s16* stream, int byte_len) {
-  std::lock_guard<std::mutex> guard(apu->buffer_mutex);
+static constexpr float kMaxAmplitude = 0.999;
+
+/**
+ * The conversion is split into simple passes over contiguous arrays without branches,
+ * so that the compiler can vectorize each of them.
+ */
+static void ScaleAndClamp(StereoSample<float> const* samples, float* stream, int count, float volume) {
+  for(int x = 0; x < count; x++) {
+    stream[x*2+0] = std::min(std::max(samples[x].left  * volume, -kMaxAmplitude), kMaxAmplitude);
+    stream[x*2+1] = std::min(std::max(samples[x].right * volume, -kMaxAmplitude), kMaxAmplitude);
+  }
+}
 
-  // Do not try to access the buffer if it wasn't setup yet.
-  if(!apu->buffer) {
-    return;
+static void ConvertToS16(float* samples, s16* stream, int length) {
+  // Round half away from zero, like std::round().
+  for(int x = 0; x < length; x++) {
+    samples[x] *= 32767.0f;
+    samples[x] += std::copysign(0.5f, samples[x]);
   }
 
-  int samples = byte_len/sizeof(s16)/2;
-  int available = apu->buffer->Available();
+  for(int x = 0; x < length; x++) {
+    stream[x] = (s16)samples[x];
+  }
+}
+
+void AudioCallback(APU* apu, s16* stream, int byte_len) {
+  static constexpr int kChunkSize = 256;
 
-  static constexpr float kMaxAmplitude = 0.999;
+  const bool f32 = apu->config->audio_dev->GetSampleFormat() == SampleFormat::F32;
+  const bool repeat = apu->config->audio_dev->GetUnderrunMode() == UnderrunMode::Repeat;
+  const int samples = byte_len / (f32 ? sizeof(float) : sizeof(s16)) / 2;
 
   const float volume = (float)std::clamp(apu->config->audio.volume, 0, 100) / 100.0f;
 
-  if(available >= samples) {
-    for(int x = 0; x < samples; x++) {
-      auto sample = apu->buffer->Read() * volume;
-      sample[0] = std::clamp(sample[0], -kMaxAmplitude, kMaxAmplitude);
-      sample[1] = std::clamp(sample[1], -kMaxAmplitude, kMaxAmplitude);
-      sample *= 32767.0;
+  std::shared_ptr<StereoRingBuffer<float>> buffer;
+  int available;
 
-      stream[x*2+0] = (s16)std::round(sample.left);
-      stream[x*2+1] = (s16)std::round(sample.right);
+  {
+    std::lock_guard<std::mutex> guard(apu->buffer_mutex);
+
+    // Do not try to access the buffer if it wasn't setup yet.
+    if(!apu->buffer) {
+      return;
     }
-  } else {
-    int y = 0;
 
-    for(int x = 0; x < samples; x++) {
-      auto sample = apu->buffer->Peek(y) * volume;
-      sample[0] = std::clamp(sample[0], -kMaxAmplitude, kMaxAmplitude);
-      sample[1] = std::clamp(sample[1], -kMaxAmplitude, kMaxAmplitude);
-      sample *= 32767.0;
+    buffer = apu->buffer;
+    available = buffer->Available();
+  }
+
+  StereoSample<float> chunk[kChunkSize];
+  float chunk_f32[kChunkSize * 2];
+
+  int y = 0;
+
+  /**
+   * Samples are copied out of the buffer in chunks, so that the mutex is only held for the copy
+   * and not for the conversion.
+   * If not enough samples are available, the available samples are either repeated without consuming them,
+   * or they are consumed and followed by silence.
+   */
+  for(int x = 0; x < samples; x += kChunkSize) {
+    const int count = std::min(samples - x, kChunkSize);
 
-      if(++y >= available) y = 0;
+    {
+      std::lock_guard<std::mutex> guard(apu->buffer_mutex);
+
+      if(available >= samples) {
+        buffer->Read(chunk, count);
+      } else if(repeat) {
+        for(int i = 0; i < count; i++) {
+          chunk[i] = buffer->Peek(y);
+
+          if(++y >= available) y = 0;
+        }
+      } else {
+        const int count_available = std::min(count, available);
+
+        buffer->Read(chunk, count_available);
+        std::fill(&chunk[count_available], &chunk[count], StereoSample<float>{});
+        available -= count_available;
+      }
+    }
 
-      stream[x*2+0] = (s16)std::round(sample.left);
-      stream[x*2+1] = (s16)std::round(sample.right);
+    if(f32) {
+      ScaleAndClamp(chunk, (float*)stream + x*2, count, volume);
+    } else {
+      ScaleAndClamp(chunk, chunk_f32, count, volume);
+      ConvertToS16(chunk_f32, stream + x*2, count * 2);
     }
   }
 }
@@ -38,6 +38,8 @@ public:
     sweep.Reset();
     enabled = false;
     step = 0;
+    stepping = false;
+    timestamp_next_step = 0;
   }
 
   void Tick() {
@@ -66,6 +68,32 @@ protected:
     enabled = false;
   }
 
+  /**
+   * Waveform steps are not scheduled as events. Instead the channels remember when their next step is due
+   * and catch up on all steps before a given timestamp when their output is needed (see Sync()).
+   * Each channel must be synced before any state that affects its output changes.
+   */
+  void StartStepping(u64 timestamp) {
+    stepping = true;
+    timestamp_next_step = timestamp;
+  }
+
+  void StopStepping() {
+    stepping = false;
+  }
+
+  bool IsStepDue(u64 timestamp) const {
+    return stepping && timestamp_next_step < timestamp;
+  }
+
+  // Returns the number of steps before the timestamp (at least one) and skips past them.
+  auto CatchUp(u64 timestamp, int interval) -> u64 {
+    const u64 steps = (timestamp - timestamp_next_step - 1) / interval + 1;
+
+    timestamp_next_step += steps * interval;
+    return steps;
+  }
+
   LengthCounter length;
   Envelope envelope;
   Sweep sweep;
@@ -73,6 +101,8 @@ protected:
 private:
   bool enabled;
   int step;
+  bool stepping;
+  u64 timestamp_next_step;
 };
 
 } // namespace nba::core
@@ -6,16 +6,12 @@
  */
 
 #include "hw/apu/channel/noise_channel.hpp"
-#include "hw/apu/registers.hpp"
 
 namespace nba::core {
 
-NoiseChannel::NoiseChannel(Scheduler& scheduler, BIAS& bias)
+NoiseChannel::NoiseChannel(Scheduler& scheduler)
     : BaseChannel(true, false)
-    , scheduler(scheduler)
-    , bias(bias) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG4_generate, this, &NoiseChannel::Generate);
-  
+    , scheduler(scheduler) {
   Reset();
 }
 
@@ -29,36 +25,30 @@ void NoiseChannel::Reset() {
 
   lfsr = 0;
   sample = 0;
-  skip_count = 0;
-
-  event = nullptr;
 }
 
-void NoiseChannel::Generate() {
+void NoiseChannel::Sync(u64 timestamp) {
+  if(!IsStepDue(timestamp)) {
+    return;
+  }
+
   if(!IsEnabled()) {
     sample = 0;
-    event = nullptr;
+    StopStepping();
     return;
   }
 
   static constexpr u16 lfsr_xor[2] = { 0x6000, 0x60 };
 
-  int carry = lfsr & 1;
-
-  lfsr >>= 1;
-  if(carry) {
-    lfsr ^= lfsr_xor[width];
-    sample = +8;
-  } else {
-    sample = -8;
-  }
-
-  sample *= envelope.current_volume;
+  const u64 steps = CatchUp(timestamp, GetSynthesisInterval(frequency_ratio, frequency_shift));
 
-  if(!dac_enable) sample = 0;
+  int carry = 0;
 
-  // Skip samples that will never be sampled by the audio mixer.
-  for(int i = 0; i < skip_count; i++) {
+  /* The LFSR has no closed form, so it is advanced in one tight loop over all due steps.
+   * Only the output of the last step is computed, since the earlier steps are inaudible.
+   * The mixer syncs the channel for every sample it mixes, so the loop stays short.
+   */
+  for(u64 i = 0; i < steps; i++) {
     carry = lfsr & 1;
     lfsr >>= 1;
     if(carry) {
@@ -66,23 +56,10 @@ void NoiseChannel::Generate() {
     }
   }
 
-  int noise_interval = GetSynthesisInterval(frequency_ratio, frequency_shift);
-  int mixer_interval = bias.GetSampleInterval();
-
-  /* If a channel generates at a higher rate than
-   * the audio mixer samples it, then it will generate samples
-   * that will be skipped anyways.
-   * In that case we can sample the channel at the same rate
-   * as the mixer rate and only output the sample that will be used.
-   */
-  if(noise_interval < mixer_interval) {
-    skip_count = mixer_interval/noise_interval - 1;
-    noise_interval = mixer_interval;
-  } else {
-    skip_count = 0;
-  }
+  sample = carry ? +8 : -8;
+  sample *= envelope.current_volume;
 
-  event = scheduler.Add(noise_interval, Scheduler::EventClass::APU_PSG4_generate);
+  if(!dac_enable) sample = 0;
 }
 
 auto NoiseChannel::Read(int offset) -> u8 {
@@ -112,6 +89,8 @@ auto NoiseChannel::Read(int offset) -> u8 {
 }
 
 void NoiseChannel::Write(int offset, u8 value) {
+  Sync(scheduler.GetTimestampNow());
+
   switch(offset) {
     // Length / Envelope
     case 0: {
@@ -142,11 +121,7 @@ void NoiseChannel::Write(int offset, u8 value) {
 
       if(dac_enable && (value & 0x80)) {
         if(!IsEnabled()) {
-          skip_count = 0;
-          if(event) {
-            scheduler.Cancel(event);
-          }
-          event = scheduler.Add(GetSynthesisInterval(frequency_ratio, frequency_shift), Scheduler::EventClass::APU_PSG4_generate);
+          StartStepping(scheduler.GetTimestampNow() + GetSynthesisInterval(frequency_ratio, frequency_shift));
         }
 
         static constexpr u16 lfsr_init[] = { 0x4000, 0x0040 };
@@ -9,12 +9,9 @@
 
 namespace nba::core {
 
-QuadChannel::QuadChannel(Scheduler& scheduler, Scheduler::EventClass event_class)
+QuadChannel::QuadChannel(Scheduler& scheduler)
     : BaseChannel(true, true)
-    , scheduler(scheduler)
-    , event_class(event_class) {
-  scheduler.Register(event_class, this, &QuadChannel::Generate);
-
+    , scheduler(scheduler) {
   Reset();
 }
 
@@ -24,13 +21,16 @@ void QuadChannel::Reset() {
   sample = 0;
   wave_duty = 0;
   dac_enable = false;
-  event = nullptr;
 }
 
-void QuadChannel::Generate() {
+void QuadChannel::Sync(u64 timestamp) {
+  if(!IsStepDue(timestamp)) {
+    return;
+  }
+
   if(!IsEnabled()) {
     sample = 0;
-    event = nullptr;
+    StopStepping();
     return;
   }
 
@@ -41,14 +41,15 @@ void QuadChannel::Generate() {
     { +8, +8, +8, +8, +8, +8, -8, -8 }
   };
 
+  const u64 steps = CatchUp(timestamp, GetSynthesisIntervalFromFrequency(sweep.current_freq));
+
+  // Only the last step is audible, the duty cycle position of it can be computed directly.
   if(dac_enable) {
-    sample = s8(pattern[wave_duty][phase] * envelope.current_volume);
+    sample = s8(pattern[wave_duty][(phase + steps - 1) % 8] * envelope.current_volume);
   } else {
     sample = 0;
   }
-  phase = (phase + 1) % 8;
-
-  event = scheduler.Add(GetSynthesisIntervalFromFrequency(sweep.current_freq), event_class);
+  phase = (phase + steps) % 8;
 }
 
 auto QuadChannel::Read(int offset) -> u8 {
@@ -82,6 +83,8 @@ auto QuadChannel::Read(int offset) -> u8 {
 }
 
 void QuadChannel::Write(int offset, u8 value) {
+  Sync(scheduler.GetTimestampNow());
+
   switch(offset) {
     // Sweep Register
     case 0: {
@@ -123,10 +126,7 @@ void QuadChannel::Write(int offset, u8 value) {
 
       if(dac_enable && (value & 0x80)) {
         if(!IsEnabled()) {
-          if(event) {
-            scheduler.Cancel(event);
-          }
-          event = scheduler.Add(GetSynthesisIntervalFromFrequency(sweep.current_freq), event_class);
+          StartStepping(scheduler.GetTimestampNow() + GetSynthesisIntervalFromFrequency(sweep.current_freq));
         }
         phase = 0;
         Restart();
@@ -12,8 +12,6 @@ namespace nba::core {
 WaveChannel::WaveChannel(Scheduler& scheduler)
     : BaseChannel(false, false, 256)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG3_generate, this, &WaveChannel::Generate);
-
   Reset(WaveChannel::ResetWaveRAM::Yes);
 }
 
@@ -37,24 +35,34 @@ void WaveChannel::Reset(ResetWaveRAM reset_wave_ram) {
       }
     }
   }
-
-  event = nullptr;
 }
 
-void WaveChannel::Generate() {
-  if(!IsEnabled()) {
+void WaveChannel::Sync(u64 timestamp) {
+  if(!IsStepDue(timestamp)) {
+    return;
+  }
+
+  if(!BaseChannel::IsEnabled()) {
     sample = 0;
-    if(BaseChannel::IsEnabled()) {
-      event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
-    } else {
-      event = nullptr;
-    }
+    StopStepping();
     return;
   }
 
-  auto byte = wave_ram[wave_bank][phase / 2];
+  const u64 steps = CatchUp(timestamp, GetSynthesisIntervalFromFrequency(frequency));
+
+  // A stopped channel keeps its timing, but does not advance through the wave RAM.
+  if(!playing) {
+    sample = 0;
+    return;
+  }
+
+  // Only the last step is audible. Find its position in the (possibly two banks long) wave RAM directly.
+  const int last_phase = (int)((phase + steps - 1) % 32);
+  const int last_bank = GetWaveBankAfter(steps - 1);
+
+  auto byte = wave_ram[last_bank][last_phase / 2];
 
-  if((phase % 2) == 0) {
+  if((last_phase % 2) == 0) {
     sample = byte >> 4;
   } else {
     sample = byte & 15;
@@ -64,17 +72,13 @@ void WaveChannel::Generate() {
 
   sample = (sample - 8) * 4 * (force_volume ? 3 : volume_table[volume]);
 
-  if(++phase == 32) {
-    phase = 0;
-    if(dimension) {
-      wave_bank ^= 1;
-    }
-  }
-
-  event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
+  wave_bank = GetWaveBankAfter(steps);
+  phase = (int)((phase + steps) % 32);
 }
 
 auto WaveChannel::Read(int offset) -> u8 {
+  Sync(scheduler.GetTimestampNow());
+
   switch(offset) {
     // Stop / Wave RAM select
     case 0: {
@@ -102,6 +106,8 @@ auto WaveChannel::Read(int offset) -> u8 {
 }
 
 void WaveChannel::Write(int offset, u8 value) {
+  Sync(scheduler.GetTimestampNow());
+
   switch(offset) {
     // Stop / Wave RAM select
     case 0: {
@@ -134,10 +140,7 @@ void WaveChannel::Write(int offset, u8 value) {
 
       if(playing && (value & 0x80)) {
         if(!BaseChannel::IsEnabled()) {
-          if(event) {
-            scheduler.Cancel(event);
-          }
-          event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
+          StartStepping(scheduler.GetTimestampNow() + GetSynthesisIntervalFromFrequency(frequency));
         }
         phase = 0;
         if(dimension) {
@@ -150,4 +153,16 @@ void WaveChannel::Write(int offset, u8 value) {
   }
 }
 
+auto WaveChannel::ReadSample(int offset) -> u8 {
+  Sync(scheduler.GetTimestampNow());
+
+  return wave_ram[wave_bank ^ 1][offset];
+}
+
+void WaveChannel::WriteSample(int offset, u8 value) {
+  Sync(scheduler.GetTimestampNow());
+
+  wave_ram[wave_bank ^ 1][offset] = value;
+}
+
 } // namespace nba::core
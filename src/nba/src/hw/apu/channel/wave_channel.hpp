@@ -26,20 +26,15 @@ public:
   void Reset(ResetWaveRAM reset_wave_ram);
   bool IsEnabled() override { return playing && BaseChannel::IsEnabled(); }
   auto GetSample() -> s8 override { return sample; }
-  void Generate();
+  void Sync(u64 timestamp);
   auto Read (int offset) -> u8;
   void Write(int offset, u8 value);
 
   void LoadState(SaveState::APU::IO::WaveChannel const& state);
   void CopyState(SaveState::APU::IO::WaveChannel& state);
 
-  auto ReadSample(int offset) -> u8 {
-    return wave_ram[wave_bank ^ 1][offset];
-  }
-
-  void WriteSample(int offset, u8 value) {
-    wave_ram[wave_bank ^ 1][offset] = value;
-  }
+  auto ReadSample(int offset) -> u8;
+  void WriteSample(int offset, u8 value);
 
 private:
   constexpr int GetSynthesisIntervalFromFrequency(int frequency) {
@@ -47,8 +42,14 @@ private:
     return 8 * (2048 - frequency);
   }
 
+  auto GetWaveBankAfter(u64 steps) -> int {
+    if(dimension) {
+      return wave_bank ^ (int)(((phase + steps) / 32) & 1);
+    }
+    return wave_bank;
+  }
+
   Scheduler& scheduler;
-  Scheduler::Event* event = nullptr;
 
   s8 sample = 0;
   bool playing;
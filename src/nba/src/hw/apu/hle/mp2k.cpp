@@ -5,6 +5,9 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <map>
 #include <nba/log.hpp>
 
 #include "bus/bus.hpp"
@@ -21,6 +24,128 @@ void MP2K::Reset() {
   for(auto& envelope : envelopes) envelope = {};
 }
 
+void MP2K::SetupWaveCache() {
+  auto const& rom = bus.memory.rom.GetRawROM();
+
+  // FNV-1a over 64-bit words, which is fast enough to hash the entire ROM once per reset.
+  u64 rom_identity = 0xCBF29CE484222325ULL ^ rom.size();
+  size_t i = 0;
+
+  for(; i + sizeof(u64) <= rom.size(); i += sizeof(u64)) {
+    u64 word;
+    std::memcpy(&word, &rom[i], sizeof(u64));
+    rom_identity = (rom_identity ^ word) * 0x100000001B3ULL;
+  }
+
+  for(; i < rom.size(); i++) {
+    rom_identity = (rom_identity ^ rom[i]) * 0x100000001B3ULL;
+  }
+
+  wave_cache = GetWaveCache(rom_identity);
+}
+
+auto MP2K::GetWaveCache(u64 rom_identity) -> std::shared_ptr<WaveCache> {
+  static std::mutex mutex;
+  static std::map<u64, std::weak_ptr<WaveCache>> caches;
+
+  std::lock_guard<std::mutex> guard(mutex);
+
+  // The cache is released once no core uses the ROM anymore.
+  auto cache = caches[rom_identity].lock();
+
+  if(!cache) {
+    cache = std::make_shared<WaveCache>();
+    caches[rom_identity] = cache;
+  }
+  return cache;
+}
+
+auto MP2K::GetDecodedWave(u32 wave_address, u8 const* wave_data, u32 number_of_samples) -> std::shared_ptr<std::vector<float>> {
+  std::lock_guard<std::mutex> guard(wave_cache->mutex);
+
+  auto& decoded_wave = wave_cache->waves[wave_address];
+
+  if(!decoded_wave) {
+    decoded_wave = std::make_shared<std::vector<float>>(number_of_samples);
+
+    float sample = 0;
+
+    for(u32 position = 0; position < number_of_samples; position++) {
+      sample = DecodeCompressedSample(wave_data, position, sample);
+      (*decoded_wave)[position] = sample;
+    }
+  }
+  return decoded_wave;
+}
+
+auto MP2K::GetWaveSize(u32 number_of_samples, bool compressed) -> u64 {
+  if(!compressed) {
+    return number_of_samples;
+  }
+
+  /**
+   * Each block of 64 samples takes 33 bytes. A partial block at the end of the wave
+   * still starts with the first sample and then holds the 4-bit differences of its samples.
+   * The sample count comes from the game, so the size is computed in 64 bits so that it cannot overflow.
+   */
+  const u32 remaining_samples = number_of_samples & 63;
+
+  u64 wave_size = (u64)(number_of_samples >> 6) * 33;
+
+  if(remaining_samples != 0) {
+    wave_size += 1 + (remaining_samples + 1) / 2;
+  }
+  return wave_size;
+}
+
+auto MP2K::DecodeCompressedSample(u8 const* wave_data, u32 position, float previous_sample) -> float {
+  static constexpr float kDifferentialLUT[] = {
+    S8ToFloat(0x00), S8ToFloat(0x01), S8ToFloat(0x04), S8ToFloat(0x09),
+    S8ToFloat(0x10), S8ToFloat(0x19), S8ToFloat(0x24), S8ToFloat(0x31),
+    S8ToFloat(0xC0), S8ToFloat(0xCF), S8ToFloat(0xDC), S8ToFloat(0xE7),
+    S8ToFloat(0xF0), S8ToFloat(0xF7), S8ToFloat(0xFC), S8ToFloat(0xFF)
+  };
+
+  // Each block of 64 samples starts with the first sample, followed by the 4-bit differences of all samples.
+  auto block_offset  = position & 63;
+  auto block_address = (position >> 6) * 33;
+
+  float sample;
+
+  if(block_offset == 0) {
+    sample = S8ToFloat(wave_data[block_address]);
+  } else {
+    sample = previous_sample;
+  }
+
+  auto address = block_address + (block_offset >> 1) + 1;
+  auto lut_index = wave_data[address];
+
+  if(block_offset & 1) {
+    lut_index &= 15;
+  } else {
+    lut_index >>= 4;
+  }
+
+  return sample + kDifferentialLUT[lut_index];
+}
+
+auto MP2K::DecodeCompressedSample(Sampler& sampler, u32 position) -> float {
+  /**
+   * A sample depends on all differences since the start of its block, including those of skipped samples.
+   * Continue from the last decoded sample if it is in the same block and otherwise start over at the block,
+   * so that the samples match the decoded waves in the cache.
+   */
+  if(position < sampler.decode_position || (position >> 6) != (sampler.decode_position >> 6)) {
+    sampler.decode_position = position & ~63;
+  }
+
+  while(sampler.decode_position <= position) {
+    sampler.decode_sample = DecodeCompressedSample(sampler.wave_data, sampler.decode_position++, sampler.decode_sample);
+  }
+  return sampler.decode_sample;
+}
+
 void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
   if(sound_info.magic != 0x68736D54) {
     return;
@@ -164,13 +289,6 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
 }
 
 void MP2K::RenderFrame() {
-  static constexpr float kDifferentialLUT[] = {
-    S8ToFloat(0x00), S8ToFloat(0x01), S8ToFloat(0x04), S8ToFloat(0x09),
-    S8ToFloat(0x10), S8ToFloat(0x19), S8ToFloat(0x24), S8ToFloat(0x31),
-    S8ToFloat(0xC0), S8ToFloat(0xCF), S8ToFloat(0xDC), S8ToFloat(0xE7),
-    S8ToFloat(0xF0), S8ToFloat(0xF7), S8ToFloat(0xFC), S8ToFloat(0xFF)
-  };
-
   current_frame = (current_frame + 1) % k_total_frame_count;
 
   const auto reverb_strength = force_reverb ? std::max(sound_info.reverb, (u8)48) : sound_info.reverb;
@@ -201,110 +319,145 @@ void MP2K::RenderFrame() {
     }
 
     bool compressed = (channel.type & 32) != 0;
-    auto sample_history = sampler.sample_history;
 
     auto const& wave_info = sampler.wave_info;
 
     if(sampler.compressed != compressed || !sampler.wave_data) {
-      auto wave_size = wave_info.number_of_samples;
-      if(compressed) {
-        wave_size *= 33;
-        wave_size = (wave_size + 63) / 64;
-      }
+      const u64 wave_size = GetWaveSize(wave_info.number_of_samples, compressed);
       const u32 wave_data_begin = channel.wave_address + sizeof(Sampler::WaveInfo);
       sampler.wave_data = bus.GetHostAddress<u8>(wave_data_begin, wave_size);
       if(sampler.wave_data == nullptr) {
-        Log<Warn>("MP2K: channel[{}] sample data has bad memory range 0x{:08X} - 0x{:08X}.", i, wave_data_begin, wave_data_begin + wave_size);
+        Log<Warn>("MP2K: channel[{}] sample data has bad memory range 0x{:08X} - 0x{:08X}.", i, wave_data_begin, wave_data_begin + (u32)wave_size);
         channel.status = 0; // Disable channel, there is no good way to deal with this.
         continue;
       }
       sampler.compressed = compressed;
+      sampler.decoded_wave = nullptr;
+      sampler.decode_position = 0;
+
+      /**
+       * Waves in RAM may be changed by the game, so only waves in ROM are cached.
+       * Implausibly long waves (most likely a garbage header) are decoded on the fly instead,
+       * so that the cache does not allocate huge amounts of memory for them.
+       */
+      if(compressed && wave_cache && wave_data_begin >= 0x08000000 && wave_info.number_of_samples <= k_max_cached_wave_samples) {
+        sampler.decoded_wave = GetDecodedWave(channel.wave_address, sampler.wave_data, wave_info.number_of_samples);
+      }
     }
 
-    auto wave_data = sampler.wave_data;
-
-    for(int j = 0; j < k_samples_per_frame; j++) {
-      const float t = j / (float)k_samples_per_frame;
-
-      const float volume_l = envelope.volume_l[0] * (1 - t) + envelope.volume_l[1] * t;
-      const float volume_r = envelope.volume_r[0] * (1 - t) + envelope.volume_r[1] * t;
-
-      if(sampler.should_fetch_sample) {
-        float sample;
+    if(UseCubicFilter()) {
+      RenderChannel<true>(channel, sampler, angular_step);
+    } else {
+      RenderChannel<false>(channel, sampler, angular_step);
+    }
 
-        if(compressed) {
-          auto block_offset  = sampler.current_position & 63;
-          auto block_address = (sampler.current_position >> 6) * 33;
+    MixChannel(destination, envelope);
+  }
+}
 
-          if(block_offset == 0) {
-            sample = S8ToFloat(wave_data[block_address]);
-          } else {
-            sample = sample_history[0];
-          }
+template<bool cubic>
+void MP2K::RenderChannel(SoundChannel& channel, Sampler& sampler, float angular_step) {
+  auto const& wave_info = sampler.wave_info;
+  auto wave_data = sampler.wave_data;
+  auto decoded_wave = sampler.decoded_wave.get();
+  auto sample_history = sampler.sample_history;
+  const bool compressed = sampler.compressed;
 
-          auto address = block_address + (block_offset >> 1) + 1;
-          auto lut_index = wave_data[address];
+  int j = 0;
 
-          if(block_offset & 1) {
-            lut_index &= 15;
-          } else {
-            lut_index >>= 4;
-          }
+  while(j < k_samples_per_frame) {
+    if(sampler.should_fetch_sample) {
+      float sample;
 
-          sample += kDifferentialLUT[lut_index];
+      if(decoded_wave) {
+        if(sampler.current_position < decoded_wave->size()) {
+          sample = (*decoded_wave)[sampler.current_position];
         } else {
-          sample = S8ToFloat(wave_data[sampler.current_position]);
+          sample = 0;
         }
-
-        if(UseCubicFilter()) {
-          sample_history[3] = sample_history[2];
-          sample_history[2] = sample_history[1];
-        }
-        sample_history[1] = sample_history[0];
-        sample_history[0] = sample;
-
-        sampler.should_fetch_sample = false;
+      } else if(compressed) {
+        sample = DecodeCompressedSample(sampler, sampler.current_position);
+      } else {
+        sample = S8ToFloat(wave_data[sampler.current_position]);
       }
 
-      float sample;
-      float mu = sampler.resample_phase;
-
-      if(UseCubicFilter()) {
-        // http://paulbourke.net/miscellaneous/interpolation/
-        float mu2 = mu * mu;
-        float a0 = sample_history[0] - sample_history[1] - sample_history[3] + sample_history[2];
-        float a1 = sample_history[3] - sample_history[2] - a0;
-        float a2 = sample_history[1] - sample_history[3];
-        float a3 = sample_history[2]; 
-        sample = a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3;
-      } else {
-        sample = sample_history[0] * mu + sample_history[1] * (1.0 - mu);
+      if constexpr(cubic) {
+        sample_history[3] = sample_history[2];
+        sample_history[2] = sample_history[1];
       }
+      sample_history[1] = sample_history[0];
+      sample_history[0] = sample;
 
-      destination[j * 2 + 0] += sample * volume_r;
-      destination[j * 2 + 1] += sample * volume_l;
+      sampler.should_fetch_sample = false;
+    }
 
-      sampler.resample_phase += angular_step;
+    /**
+     * The sample history only changes when the next input sample is fetched,
+     * so the interpolation coefficients are computed once for all output samples until then.
+     */
+    float resample_phase = sampler.resample_phase;
+
+    if constexpr(cubic) {
+      // http://paulbourke.net/miscellaneous/interpolation/
+      const float a0 = sample_history[0] - sample_history[1] - sample_history[3] + sample_history[2];
+      const float a1 = sample_history[3] - sample_history[2] - a0;
+      const float a2 = sample_history[1] - sample_history[3];
+      const float a3 = sample_history[2];
+
+      do {
+        const float mu = resample_phase;
+        const float mu2 = mu * mu;
+
+        channel_buffer[j++] = a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3;
+        resample_phase += angular_step;
+      } while(resample_phase < 1 && j < k_samples_per_frame);
+    } else {
+      do {
+        const float mu = resample_phase;
 
-      if(sampler.resample_phase >= 1) {
-        auto n = int(sampler.resample_phase);
-        sampler.resample_phase -= n;
-        sampler.current_position += n;
-        sampler.should_fetch_sample = true;
+        channel_buffer[j++] = sample_history[0] * mu + sample_history[1] * (1.0 - mu);
+        resample_phase += angular_step;
+      } while(resample_phase < 1 && j < k_samples_per_frame);
+    }
+
+    sampler.resample_phase = resample_phase;
+
+    if(sampler.resample_phase >= 1) {
+      auto n = int(sampler.resample_phase);
+      sampler.resample_phase -= n;
+      sampler.current_position += n;
+      sampler.should_fetch_sample = true;
 
-        if(sampler.current_position >= wave_info.number_of_samples) {
-          if(channel.status & CHANNEL_LOOP) {
-            sampler.current_position = wave_info.loop_position + n - 1;
-          } else {
-            sampler.current_position = wave_info.number_of_samples;
-            sampler.should_fetch_sample = false;
-          }
+      if(sampler.current_position >= wave_info.number_of_samples) {
+        if(channel.status & CHANNEL_LOOP) {
+          sampler.current_position = wave_info.loop_position + n - 1;
+        } else {
+          sampler.current_position = wave_info.number_of_samples;
+          sampler.should_fetch_sample = false;
         }
       }
     }
   }
 }
 
+void MP2K::MixChannel(float* destination, Envelope const& envelope) {
+  // The volumes are copied to locals, because the compiler cannot vectorize the loop if they may alias the destination.
+  const float volume_l0 = envelope.volume_l[0];
+  const float volume_l1 = envelope.volume_l[1];
+  const float volume_r0 = envelope.volume_r[0];
+  const float volume_r1 = envelope.volume_r[1];
+
+  for(int j = 0; j < k_samples_per_frame; j++) {
+    const float t = j / (float)k_samples_per_frame;
+
+    const float volume_l = volume_l0 * (1 - t) + volume_l1 * t;
+    const float volume_r = volume_r0 * (1 - t) + volume_r1 * t;
+
+    destination[j * 2 + 0] += channel_buffer[j] * volume_r;
+    destination[j * 2 + 1] += channel_buffer[j] * volume_l;
+  }
+}
+
 void MP2K::RenderReverb(float* destination, u8 strength) {
   static constexpr float k_early_coefficient = 0.0015;
 
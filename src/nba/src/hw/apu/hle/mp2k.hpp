@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <nba/integer.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace nba::core {
 
@@ -82,6 +86,7 @@ struct MP2K {
   }
 
   void Reset();  
+  void SetupWaveCache();
   void SoundMainRAM(SoundInfo const& sound_info);
   void RenderFrame();
   auto ReadSample() -> float*;
@@ -90,6 +95,7 @@ private:
   static constexpr int k_sample_rate = 65536;
   static constexpr int k_samples_per_frame = k_sample_rate / 60 + 1;
   static constexpr int k_total_frame_count = 7;
+  static constexpr u32 k_max_cached_wave_samples = 0x400000;
 
   static constexpr float S8ToFloat(s8 value) {
     return value / 127.0;
@@ -99,6 +105,31 @@ private:
     return value / 256.0;
   }
 
+  struct Sampler;
+  struct Envelope;
+
+  /**
+   * Decoded samples of the compressed (DPCM) waves in ROM, indexed by wave address.
+   * Waves are decoded once when they are first played and the cache is shared by all cores that run the same ROM.
+   */
+  struct WaveCache {
+    std::mutex mutex;
+    std::unordered_map<u32, std::shared_ptr<std::vector<float>>> waves;
+  };
+
+  static auto GetWaveCache(u64 rom_identity) -> std::shared_ptr<WaveCache>;
+  static auto GetWaveSize(u32 number_of_samples, bool compressed) -> u64;
+  static auto DecodeCompressedSample(u8 const* wave_data, u32 position, float previous_sample) -> float;
+  static auto DecodeCompressedSample(Sampler& sampler, u32 position) -> float;
+  auto GetDecodedWave(u32 wave_address, u8 const* wave_data, u32 number_of_samples) -> std::shared_ptr<std::vector<float>>;
+
+  /**
+   * Channels are rendered in two passes: the interpolated samples are generated into `channel_buffer` first,
+   * and then mixed with the envelope ramp applied in a loop that the compiler can vectorize.
+   */
+  template<bool cubic>
+  void RenderChannel(SoundChannel& channel, Sampler& sampler, float angular_step);
+  void MixChannel(float* destination, Envelope const& envelope);
   void RenderReverb(float* destination, u8 strength);
 
   struct Sampler {
@@ -108,6 +139,10 @@ private:
     float resample_phase = 0.0;
     float sample_history[4] {0};
 
+    // Next position to decode and the last decoded sample, for compressed waves that are decoded on the fly.
+    u32 decode_position = 0;
+    float decode_sample = 0.0;
+
     struct WaveInfo {
       u16 type;
       u16 status;
@@ -117,6 +152,7 @@ private:
     } wave_info;
 
     u8* wave_data = nullptr;
+    std::shared_ptr<std::vector<float>> decoded_wave;
   } samplers[kMaxSoundChannels];
 
   struct Envelope {
@@ -129,8 +165,10 @@ private:
   bool use_cubic_filter = false;
   bool force_reverb = false;
   Bus& bus;
+  std::shared_ptr<WaveCache> wave_cache;
   SoundInfo sound_info;
   std::unique_ptr<float[]> buffer;
+  float channel_buffer[k_samples_per_frame];
   int current_frame;
   int buffer_read_index;
 };
@@ -29,6 +29,29 @@ void APU::LoadState(SaveState const& state) {
 
   resolution_old = state.apu.resolution_old;
 
+  // The timers report their lazy overflows again when their state is loaded.
+  lazy_overflows[0] = {};
+  lazy_overflows[1] = {};
+  fifo_refill_event = scheduler.GetEventByUID(state.apu.fifo_refill_event_uid);
+
+  mixer.event = scheduler.GetEventByUID(state.apu.mixer_event_uid);
+
+  // The state may have been saved by a core with audio enabled or disabled.
+  if(audio_enabled) {
+    // The next sample is due at the next multiple of the sample interval, just like for the free-running mixer.
+    const u64 timestamp_now = scheduler.GetTimestampNow();
+    const int sample_interval = mmio.bias.GetSampleInterval();
+
+    mixer.timestamp_next_sample = timestamp_now + sample_interval - (timestamp_now & (sample_interval - 1));
+
+    if(!mixer.event) {
+      mixer.event = scheduler.Add(Mixer::k_block_cycles, Scheduler::EventClass::APU_mixer);
+    }
+  } else if(mixer.event) {
+    scheduler.Cancel(mixer.event);
+    mixer.event = nullptr;
+  }
+
   // We are simply resetting the MP2K mixer for now,
   // there probably is no need to do complicated (de)serialization.
   mp2k.Reset();
@@ -51,6 +74,8 @@ void APU::CopyState(SaveState& state) {
   }
 
   state.apu.resolution_old = resolution_old;
+  state.apu.fifo_refill_event_uid = GetEventUID(fifo_refill_event);
+  state.apu.mixer_event_uid = GetEventUID(mixer.event);
 }
 
 void BaseChannel::LoadState(SaveState::APU::IO::PSG const& state) {
@@ -79,6 +104,9 @@ void BaseChannel::LoadState(SaveState::APU::IO::PSG const& state) {
   sweep.divider = state.sweep.divider;
   sweep.shift = state.sweep.shift;
   sweep.step = state.sweep.step;
+
+  stepping = state.stepping;
+  timestamp_next_step = state.timestamp_next_step;
 }
 
 void BaseChannel::CopyState(SaveState::APU::IO::PSG& state) {
@@ -107,6 +135,9 @@ void BaseChannel::CopyState(SaveState::APU::IO::PSG& state) {
   state.sweep.divider = sweep.divider;
   state.sweep.shift = sweep.shift;
   state.sweep.step = sweep.step;
+
+  state.stepping = stepping;
+  state.timestamp_next_step = timestamp_next_step;
 }
 
 void QuadChannel::LoadState(SaveState::APU::IO::QuadChannel const& state) {
@@ -116,7 +147,6 @@ void QuadChannel::LoadState(SaveState::APU::IO::QuadChannel const& state) {
   phase = state.phase;
   wave_duty = state.wave_duty;
   sample = state.sample;
-  event = scheduler.GetEventByUID(state.event_uid);
 }
 
 void QuadChannel::CopyState(SaveState::APU::IO::QuadChannel& state) {
@@ -126,7 +156,6 @@ void QuadChannel::CopyState(SaveState::APU::IO::QuadChannel& state) {
   state.phase = phase;
   state.wave_duty = wave_duty;
   state.sample = sample;
-  state.event_uid = GetEventUID(event);
 }
 
 void WaveChannel::LoadState(SaveState::APU::IO::WaveChannel const& state) {
@@ -139,7 +168,6 @@ void WaveChannel::LoadState(SaveState::APU::IO::WaveChannel const& state) {
   frequency = state.frequency;
   dimension = state.dimension;
   wave_bank = state.wave_bank;
-  event = scheduler.GetEventByUID(state.event_uid);
 
   std::memcpy(wave_ram, state.wave_ram, sizeof(wave_ram));
 }
@@ -154,7 +182,6 @@ void WaveChannel::CopyState(SaveState::APU::IO::WaveChannel& state) {
   state.frequency = frequency;
   state.dimension = dimension;
   state.wave_bank = wave_bank;
-  state.event_uid = GetEventUID(event);
 
   std::memcpy(state.wave_ram, wave_ram, sizeof(wave_ram));
 }
@@ -166,7 +193,6 @@ void NoiseChannel::LoadState(SaveState::APU::IO::NoiseChannel const& state) {
   frequency_shift = state.frequency_shift;
   frequency_ratio = state.frequency_ratio;
   width = state.width;
-  event = scheduler.GetEventByUID(state.event_uid);
 }
 
 void NoiseChannel::CopyState(SaveState::APU::IO::NoiseChannel& state) {
@@ -176,7 +202,6 @@ void NoiseChannel::CopyState(SaveState::APU::IO::NoiseChannel& state) {
   state.frequency_shift = frequency_shift;
   state.frequency_ratio = frequency_ratio;
   state.width = width;
-  state.event_uid = GetEventUID(event);
 }
 
 } // namespace nba::core
@@ -68,7 +68,56 @@ void PPU::DrawBackground() {
 
 template<int mode> void PPU::DrawBackgroundImpl(int cycles) {
   const u16 latched_dispcnt_and_current_dispcnt = mmio.dispcnt_latch[0] & mmio.dispcnt.hword;
-  
+
+  // DISPCNT enable bits of the BGs that are available in this mode.
+  constexpr u16 enable_mask = mode == 0 ? 0x0F00U :
+                              mode == 1 ? 0x0700U :
+                              mode == 2 ? 0x0C00U :
+                              mode <= 5 ? 0x0400U : 0U;
+
+  /**
+   * If all BGs are disabled no VRAM is accessed, so the only thing left to do
+   * is the end-of-scanline work in cycle 1232 (which does not depend on the cycles before it).
+   */
+  if((latched_dispcnt_and_current_dispcnt & enable_mask) == 0U) {
+    if(bg.cycle + (uint)cycles < 1232U) {
+      bg.cycle += (uint)cycles;
+      return;
+    }
+
+    bg.cycle = 1231U;
+    cycles = 1;
+  }
+
+  /**
+   * Affine BGs are rendered in spans rather than cycle-by-cycle.
+   * Text-mode BGs may observe the VRAM latch from preceding affine BG fetches,
+   * so this is only done when no text-mode BG is enabled.
+   */
+  if constexpr(mode == 1 || mode == 2) {
+    if(mode == 2 || (latched_dispcnt_and_current_dispcnt & 0x0300U) == 0U) {
+      const uint cycle_begin = 1U + bg.cycle;
+      const uint cycle_end = cycle_begin + (uint)cycles;
+
+      // Render the BG which is fetched last in the span last, so that it determines the final VRAM access timestamp and latch.
+      const uint last_id = (~((std::min(cycle_end, 1007U) - 1U) >> 1)) & 1U;
+
+      for(const uint id : {last_id ^ 1U, last_id}) {
+        if((id == 0 || mode == 2) && (latched_dispcnt_and_current_dispcnt & (1024U << id))) {
+          RenderMode2BGSpan(id, cycle_begin, cycle_end);
+        }
+      }
+
+      if(cycle_end <= 1232U) {
+        bg.cycle += (uint)cycles;
+        return;
+      }
+
+      bg.cycle = 1231U;
+      cycles = 1;
+    }
+  }
+
   /**
    * @todo: we are losing out on some possible optimizations,
    * by implementing the various BG modes in separate methods,
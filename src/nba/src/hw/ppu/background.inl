@@ -178,6 +178,75 @@ void ALWAYS_INLINE RenderMode2BG(uint id, uint cycle) {
   }
 }
 
+void RenderMode2BGSpan(uint id, uint cycle_begin, uint cycle_end) {
+  const auto& bgcnt = mmio.bgcnt[2 + id];
+
+  // The tile map of BG2 is fetched in cycles 34 + 4 * x and the tile map of BG3 in cycles 32 + 4 * x.
+  // Each tile map fetch is followed by a tile data fetch in the next cycle.
+  const uint cycle_base = 34U - (id << 1);
+
+  uint cycle = std::max(cycle_begin, cycle_base);
+
+  cycle_end = std::min(cycle_end, 1007U);
+
+  if((cycle - cycle_base) & 2U) {
+    cycle = (cycle - ((cycle - cycle_base) & 3U)) + 4U;
+  }
+
+  // Complete a pixel for which the tile map was fetched before the start of the span.
+  if(cycle < cycle_end && ((cycle - cycle_base) & 1U)) {
+    RenderMode2BG(id, cycle);
+    cycle += 3U;
+  }
+
+  /**
+   * Sample all complete pixels except for the last one in one go.
+   * The last pixel goes through the cycle-accurate path, because the VRAM access timestamp
+   * and the VRAM latch only depend on the last VRAM access.
+   * Note that VRAM and the BG registers cannot change within the span.
+   */
+  if(cycle + 6U <= cycle_end) {
+    const uint pixels = (cycle_end - cycle - 2U) / 4U;
+
+    const uint x0 = (cycle - 32U) >> 2;
+
+    auto& affine = bg.affine[id];
+
+    const s32 dx = mmio.bgpa[id];
+    const s32 dy = mmio.bgpc[id];
+
+    u8 indices[256];
+
+    if(ForcedBlank()) {
+      std::fill_n(indices, pixels, 0U);
+    } else {
+      SampleAffineBackground(
+        vram, bgcnt.map_block << 11, bgcnt.tile_block << 14, bgcnt.size, bgcnt.wraparound,
+        affine.x, affine.y, dx, dy, (int)pixels, indices
+      );
+    }
+
+    for(uint i = 0; i < pixels && x0 + i < 240U; i++) {
+      bg.buffer[x0 + i][2 + id] = indices[i];
+    }
+
+    affine.x += (s32)pixels * dx;
+    affine.y += (s32)pixels * dy;
+
+    cycle += pixels * 4U;
+  }
+
+  while(cycle < cycle_end) {
+    RenderMode2BG(id, cycle);
+
+    if(cycle + 1U < cycle_end) {
+      RenderMode2BG(id, cycle + 1U);
+    }
+
+    cycle += 4U;
+  }
+}
+
 void ALWAYS_INLINE RenderMode3BG(uint cycle) {
   if(cycle < 32U || (cycle & 3U) != 3U) {
     return;
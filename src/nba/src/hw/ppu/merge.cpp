@@ -6,18 +6,39 @@
  */
 
 #include <algorithm>
+#include <array>
 
 #include "ppu.hpp"
 
 namespace nba::core {
 
-static u32 RGB555(u16 rgb555) {
-  const uint r = (rgb555 >>  0) & 31U;
-  const uint g = (rgb555 >>  5) & 31U;
-  const uint b = (rgb555 >> 10) & 31U;
+static const auto k_rgb555_to_argb8888 = []() {
+  std::array<u32, 32768> lut;
 
-  return 0xFF000000 | (r << 3 | r >> 2) << 16 | (g << 3 | g >> 2) << 8 | (b << 3 | b >> 2);
-}
+  for(uint rgb555 = 0; rgb555 < 32768U; rgb555++) {
+    const uint r = (rgb555 >>  0) & 31U;
+    const uint g = (rgb555 >>  5) & 31U;
+    const uint b = (rgb555 >> 10) & 31U;
+
+    lut[rgb555] = 0xFF000000 | (r << 3 | r >> 2) << 16 | (g << 3 | g >> 2) << 8 | (b << 3 | b >> 2);
+  }
+
+  return lut;
+}();
+
+static const auto k_rgb555_to_rgb565 = []() {
+  std::array<u16, 32768> lut;
+
+  for(uint rgb555 = 0; rgb555 < 32768U; rgb555++) {
+    const uint r = (rgb555 >>  0) & 31U;
+    const uint g = (rgb555 >>  5) & 31U;
+    const uint b = (rgb555 >> 10) & 31U;
+
+    lut[rgb555] = (u16)(r << 11 | (g << 1 | g >> 4) << 5 | b);
+  }
+
+  return lut;
+}();
 
 void PPU::InitMerge() {
   const u64 timestamp_now = scheduler.GetTimestampNow();
@@ -41,11 +62,21 @@ void PPU::DrawMerge() {
   }
 
   // @todo: possibly template this based on IO configuration
-  DrawMergeImpl(cycles);
+  if(skip_frame) {
+    DrawMergeImpl<false>(cycles);
+  } else {
+    DrawMergeImpl<true>(cycles);
+  }
 
   merge.timestamp_last_sync = timestamp_now;
 }
 
+/**
+ * On skipped frames (compose = false) the layer, window and blend selection still runs,
+ * because it decides when colors are fetched from PRAM, which is observable through PRAM access timing.
+ * Only the color math and the output are skipped.
+ */
+template<bool compose>
 void PPU::DrawMergeImpl(int cycles) {
   static constexpr int k_min_max_bg[8][2] {
     {0,  3}, // Mode 0 (BG0 - BG3 text-mode)
@@ -102,9 +133,9 @@ void PPU::DrawMergeImpl(int cycles) {
 
     // @todo: optimize this, this is baaad
     if(have_windows) {
-      if(enable_win0 && window.buffer[x][0]) {
+      if(enable_win0 && window.buffer[0][x]) {
         win_layer_enable = mmio.winin.enable[0];
-      } else if(enable_win1 && window.buffer[x][1]) {
+      } else if(enable_win1 && window.buffer[1][x]) {
         win_layer_enable = mmio.winin.enable[1];
       } else if(enable_objwin && sprite.buffer_rd[x].window) {
         win_layer_enable = mmio.winout.enable[1];
@@ -195,7 +226,9 @@ void PPU::DrawMergeImpl(int cycles) {
             colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
           }
 
-          colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+          if constexpr(compose) {
+            colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+          }
         } else if(!have_windows || win_layer_enable[LAYER_SFX]) {
           const bool have_dst = mmio.bldcnt.targets[0][layers[0]];
 
@@ -207,18 +240,20 @@ void PPU::DrawMergeImpl(int cycles) {
                   colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
                 }
 
-                colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+                if constexpr(compose) {
+                  colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
+                }
               }
               break;
             }
             case BlendControl::SFX_BRIGHTEN: {
-              if(have_dst) {
+              if(compose && have_dst) {
                 colors[0] = Brighten(colors[0], mmio.evy);
               }
               break;
             }
             case BlendControl::SFX_DARKEN: {
-              if(have_dst) {
+              if(compose && have_dst) {
                 colors[0] = Darken(colors[0], mmio.evy);
               }
               break;
@@ -227,26 +262,51 @@ void PPU::DrawMergeImpl(int cycles) {
         }
       }
 
-      if(x & 1) {
-        u16 color_l = merge.color_l;
-        u16 color_r = colors[0];
+      if constexpr(compose) {
+        if(x & 1) {
+          u16 color_l = merge.color_l;
+          u16 color_r = colors[0];
 
-        if(mmio.greenswap & 1) {
-          const u16 mask = 31U << 5;
+          if(mmio.greenswap & 1) {
+            const u16 mask = 31U << 5;
 
-          u16 g_l = color_l & mask;
-          u16 g_r = color_r & mask;
+            u16 g_l = color_l & mask;
+            u16 g_r = color_r & mask;
 
-          color_l = (color_l & ~mask) | g_r;
-          color_r = (color_r & ~mask) | g_l;
-        }
+            color_l = (color_l & ~mask) | g_r;
+            color_r = (color_r & ~mask) | g_l;
+          }
 
-        u32* out = &output[frame][mmio.vcount * 240 + (x & ~1)];
+          const uint offset = mmio.vcount * 240 + (x & ~1);
 
-        out[0] = RGB555(color_l);
-        out[1] = RGB555(color_r);
-      } else {
-        merge.color_l = colors[0];
+          frame_hash = (frame_hash ^ (color_l | (u32)color_r << 16)) * 0x100000001B3ULL;
+
+          switch(pixel_format) {
+            case PixelFormat::ARGB8888: {
+              u32* out = &frame_buffer[offset];
+
+              out[0] = k_rgb555_to_argb8888[color_l & 0x7FFF];
+              out[1] = k_rgb555_to_argb8888[color_r & 0x7FFF];
+              break;
+            }
+            case PixelFormat::BGR555: {
+              u16* out = (u16*)frame_buffer + offset;
+
+              out[0] = color_l & 0x7FFF;
+              out[1] = color_r & 0x7FFF;
+              break;
+            }
+            case PixelFormat::RGB565: {
+              u16* out = (u16*)frame_buffer + offset;
+
+              out[0] = k_rgb555_to_rgb565[color_l & 0x7FFF];
+              out[1] = k_rgb555_to_rgb565[color_r & 0x7FFF];
+              break;
+            }
+          }
+        } else {
+          merge.color_l = colors[0];
+        }
       }
 
       if(++merge.mosaic_x[0] == (uint)mmio.mosaic.bg.size_x) {
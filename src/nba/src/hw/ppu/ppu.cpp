@@ -5,6 +5,7 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
 #include <cstring>
 
 #include "hw/ppu/ppu.hpp"
@@ -35,6 +36,9 @@ PPU::PPU(
 
   mmio.dispcnt.ppu = this;
   mmio.dispstat.ppu = this;
+  mmio.winh[0].ppu = this;
+  mmio.winh[1].ppu = this;
+  SetFrameSkip(config->frameskip);
   Reset();
 }
 
@@ -97,11 +101,24 @@ void PPU::Reset() {
   sprite = {};
   sprite.buffer_rd = sprite.buffer[0];
   sprite.buffer_wr = sprite.buffer[1];
+  InvalidateSpriteLineMasks();
   window = {};
   merge = {};
 
   frame = 0;
+  have_last_frame_hash = false;
+  SelectFrameBuffer();
+  frameskip_counter = 0;
+  skip_frame = false;
+  present_output = true;
   dma3_video_transfer_running = false;
+
+  // The PPU state after reset does not necessarily reflect V-blank, so we can only enter the idle state on the next V-blank.
+  idle = false;
+}
+
+void PPU::SetFrameSkip(int frameskip) {
+  this->frameskip = std::max(frameskip, 0);
 }
 
 void PPU::BeginHDrawVDraw() {
@@ -109,7 +126,6 @@ void PPU::BeginHDrawVDraw() {
   auto& vcount = mmio.vcount;
 
   DrawBackground();
-  DrawWindow();
   DrawMerge();
 
   scheduler.Add(1, Scheduler::EventClass::PPU_update_vcount_flag);
@@ -124,6 +140,11 @@ void PPU::BeginHDrawVDraw() {
     scheduler.Add(1007, Scheduler::EventClass::PPU_hblank_vblank);
     RequestVblankDMA();
     dispstat.vblank_flag = 1;
+    idle = true;
+
+    if(snapshot_mailbox.HasSubscribers()) {
+      TakeSnapshot();
+    }
 
     if(dispstat.vblank_irq_enable) {
       scheduler.Add(1, Scheduler::EventClass::PPU_vblank_irq);
@@ -154,8 +175,6 @@ void PPU::BeginHDrawVBlank() {
   auto& vcount = mmio.vcount;
   auto& dispstat = mmio.dispstat;
 
-  DrawWindow();
-
   scheduler.Add(1, Scheduler::EventClass::PPU_update_vcount_flag);
 
   dispstat.hblank_flag = 0;
@@ -177,8 +196,9 @@ void PPU::BeginHDrawVBlank() {
     scheduler.Add(1007, Scheduler::EventClass::PPU_hblank_vdraw);
     vcount = 0;
 
-    config->video_dev->Draw(output[frame]);
-    frame ^= 1;
+    if(present_output) {
+      PresentFrame();
+    }
 
     InitBackground();
     InitMerge();
@@ -187,6 +207,14 @@ void PPU::BeginHDrawVBlank() {
     
     if(++vcount == 227) {
       dispstat.vblank_flag = 0;
+      idle = false;
+
+      /**
+       * The sprite engine begins fetching for the first scanline of the next frame during this scanline,
+       * so we have to decide now if the next frame will be composed or skipped.
+       */
+      present_output = !skip_frame;
+      UpdateFrameSkip();
     }
   }
 
@@ -249,7 +277,126 @@ void PPU::UpdateVideoTransferDMA() {
   }
 }
 
+void PPU::UpdateFrameSkip() {
+  /**
+   * On skipped frames all timing-related behavior (V-count, DISPSTAT, IRQs, DMAs and VRAM/PRAM access timing)
+   * stays intact, but the final pixel colors are not computed and the frame is not presented to the video device.
+   */
+  if(!config->video_dev->WantsFrames()) {
+    skip_frame = true;
+    return;
+  }
+
+  if(frameskip_counter >= frameskip) {
+    frameskip_counter = 0;
+    skip_frame = false;
+  } else {
+    frameskip_counter++;
+    skip_frame = true;
+  }
+}
+
+void PPU::PresentFrame() {
+  auto& video_dev = *config->video_dev;
+  auto mailbox = video_dev.GetFrameMailbox();
+
+  /**
+   * If the frame is identical to the previously presented frame, we keep composing into the same buffer
+   * and let the video device know that it may skip presenting the frame.
+   */
+  if(have_last_frame_hash && frame_hash == last_frame_hash) {
+    video_dev.DrawUnchanged(frame_buffer);
+  } else {
+    if(mailbox) {
+      mailbox->Publish();
+    }
+
+    video_dev.Draw(frame_buffer);
+
+    if(!mailbox) {
+      frame ^= 1;
+    }
+
+    last_frame_hash = frame_hash;
+    have_last_frame_hash = true;
+  }
+
+  SelectFrameBuffer();
+}
+
+void PPU::TakeSnapshot() {
+  static constexpr u32 k_block_size = PPUSnapshot::k_block_size;
+
+  auto& latest = snapshot_mailbox.GetLatestSnapshot();
+  auto& snapshot = snapshot_mailbox.GetWriteBuffer();
+
+  const u64 sequence = latest.sequence + 1;
+
+  /**
+   * Usually only a small part of VRAM changes from one frame to the next.
+   * Instead of tracking writes in the memory access hot paths, we compare the memories to the latest snapshot
+   * in blocks, to find out which blocks changed. The write buffer holds an older snapshot,
+   * so from it we only need to update the blocks that changed after it was taken.
+   */
+  const auto update_blocks = [&](u8* dst, u64* dst_versions, u8 const* src, u8 const* src_latest, u64 const* latest_versions, u32 size) {
+    for(u32 block = 0; block < size / k_block_size; block++) {
+      const u32 offset = block * k_block_size;
+
+      u64 version = latest_versions[block];
+
+      if(std::memcmp(&src[offset], &src_latest[offset], k_block_size) != 0) {
+        version = sequence;
+      }
+
+      if(version > snapshot.sequence) {
+        std::memcpy(&dst[offset], &src[offset], k_block_size);
+      }
+
+      dst_versions[block] = version;
+    }
+  };
+
+  update_blocks(snapshot.pram, snapshot.pram_version, pram, latest.pram, latest.pram_version, sizeof(pram));
+  update_blocks(snapshot.oam,  snapshot.oam_version,  oam,  latest.oam,  latest.oam_version,  sizeof(oam));
+  update_blocks(snapshot.vram, snapshot.vram_version, vram, latest.vram, latest.vram_version, sizeof(vram));
+
+  snapshot.sequence = sequence;
+
+  snapshot.dispcnt = mmio.dispcnt.ReadHalf();
+
+  for(int id = 0; id < 4; id++) {
+    snapshot.bgcnt[id] = mmio.bgcnt[id].ReadHalf();
+    snapshot.bghofs[id] = mmio.bghofs[id];
+    snapshot.bgvofs[id] = mmio.bgvofs[id];
+  }
+
+  snapshot_mailbox.Publish();
+}
+
+void PPU::SelectFrameBuffer() {
+  auto mailbox = config->video_dev->GetFrameMailbox();
+
+  pixel_format = config->video_dev->GetPixelFormat();
+
+  // The pixel format is part of the hash, so that a change of the pixel format is never mistaken for an unchanged frame.
+  frame_hash = 0xCBF29CE484222325ULL ^ (u64)pixel_format;
+
+  if(mailbox) {
+    frame_buffer = mailbox->GetWriteBuffer();
+  } else {
+    frame_buffer = output[frame];
+  }
+}
+
 void PPU::LatchDISPCNT() {
+  /**
+   * The bus does not synchronize the PPU on PRAM and BG VRAM accesses during forced blank.
+   * Forced blank may end here, so we have to catch up before that happens.
+   */
+  if(ForcedBlank()) {
+    Sync();
+  }
+
   mmio.dispcnt_latch[0] = mmio.dispcnt_latch[1];
   mmio.dispcnt_latch[1] = mmio.dispcnt_latch[2];
   mmio.dispcnt_latch[2] = mmio.dispcnt.hword;
@@ -7,11 +7,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <nba/common/affine_sampler.hpp>
 #include <nba/common/compiler.hpp>
 #include <nba/common/punning.hpp>
 #include <nba/config.hpp>
 #include <nba/integer.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <nba/save_state.hpp>
 #include <nba/scheduler.hpp>
 #include <type_traits>
@@ -31,6 +34,7 @@ struct PPU {
   );
 
   void Reset();
+  void SetFrameSkip(int frameskip);
 
   void LoadState(SaveState const& state);
   void CopyState(SaveState& state);
@@ -47,6 +51,10 @@ struct PPU {
     return oam;
   }
 
+  auto GetSnapshotMailbox() -> PPUSnapshotMailbox& {
+    return snapshot_mailbox;
+  }
+
   template<typename T>
   auto ALWAYS_INLINE ReadPRAM(u32 address) noexcept -> T {
     return read<T>(pram, address & 0x3FF);
@@ -129,7 +137,16 @@ struct PPU {
   template<typename T>
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
     if constexpr (!std::is_same_v<T, u8>) {
-      write<T>(oam, address & 0x3FF, value);
+      address &= 0x3FF;
+
+      write<T>(oam, address, value);
+
+      // Attributes #0 and #1 decide on which scanlines an OAM entry is visible.
+      if((address & 7U) < 4U) {
+        const uint index = address >> 3;
+
+        sprite.dirty_mask[index >> 6] |= 1ULL << (index & 63U);
+      }
     }
   }
 
@@ -149,13 +166,23 @@ struct PPU {
     return scheduler.GetTimestampNow() == sprite.timestamp_oam_access + 1U;
   }
 
+  /**
+   * During V-blank the PPU does not access PRAM, VRAM or OAM at all, so the bus
+   * may skip synchronizing the PPU and checking for access conflicts.
+   * The sprite engine starts fetching for the first scanline during scanline 227.
+   */
+  bool ALWAYS_INLINE IsIdle() const noexcept {
+    return idle;
+  }
+
+  // BG VRAM and PRAM are not accessed during forced blank either (but OAM and OBJ VRAM are).
+  bool ALWAYS_INLINE IsIdleOrForcedBlank() const noexcept {
+    return idle || ForcedBlank();
+  }
+
   void Sync() {
-    // @todo: only update the window when it is necessary or else
-    // we will have a major performance caveat due to the window being updated 
-    // during V-blank and games typically updating graphics during V-blank.
     DrawBackground();
     DrawSprite();
-    DrawWindow();
     DrawMerge();
   }
 
@@ -195,6 +222,7 @@ struct PPU {
 
 private:
   friend struct DisplayStatus;
+  friend struct WindowRange;
 
   enum ObjAttribute {
     OBJ_IS_ALPHA  = 1,
@@ -237,6 +265,10 @@ private:
 
   void UpdateVerticalCounterFlag();
   void UpdateVideoTransferDMA();
+  void UpdateFrameSkip();
+  void PresentFrame();
+  void SelectFrameBuffer();
+  void TakeSnapshot();
   void LatchDISPCNT();
 
   void RequestVideoDMA() {
@@ -361,6 +393,12 @@ private:
     Pixel* buffer_wr;
 
     uint latch_cycle_limit;
+
+    // Masks of the OAM entries which are visible on each scanline (one bit per OAM entry).
+    u64 line_mask[160][2];
+
+    // Masks of the OAM entries which need to be re-evaluated because attribute #0 or #1 changed.
+    u64 dirty_mask[2];
   } sprite;
 
   void InitSprite();
@@ -368,19 +406,26 @@ private:
   void DrawSpriteImpl(int cycles);
   void DrawSpriteFetchOAM(uint cycle);
   void DrawSpriteFetchVRAM(uint cycle);
+  void InvalidateSpriteLineMasks();
+  void UpdateSpriteLineMasks();
+  auto FindNextVisibleSprite(uint index) -> uint;
 
   struct Window {
-    u64 timestamp_last_sync;
-    uint cycle;
+    u64 timestamp_init;
+    uint x;
 
     bool v_flag[2] {false, false};
     bool h_flag[2] {false, false};
 
-    bool buffer[240][2];
+    uint h_min[2];
+    uint h_max[2];
+
+    bool buffer[2][240];
   } window;
 
   void InitWindow();
   void DrawWindow();
+  auto DrawWindowSpan(int id, uint x_min, uint x_max, bool h_flag, bool draw) -> bool;
 
   struct Merge {
     u64 timestamp_init = 0;
@@ -398,7 +443,7 @@ private:
 
   void InitMerge();
   void DrawMerge();
-  void DrawMergeImpl(int cycles);
+  template<bool compose> void DrawMergeImpl(int cycles);
   
   static auto Blend(u16 color_a, u16 color_b, int eva, int evb) -> u16;
   static auto Brighten(u16 color, int evy) -> u16;
@@ -454,10 +499,25 @@ private:
   DMA& dma;
   std::shared_ptr<Config> config;
 
+  PPUSnapshotMailbox snapshot_mailbox;
+
   u32 output[2][240 * 160];
   int frame;
+  u32* frame_buffer;
+  PixelFormat pixel_format;
+
+  // Hash of the colors composed in the current frame, used to detect unchanged frames.
+  u64 frame_hash;
+  u64 last_frame_hash;
+  bool have_last_frame_hash;
+
+  int frameskip;
+  int frameskip_counter;
+  bool skip_frame;
+  bool present_output;
 
   bool dma3_video_transfer_running;
+  bool idle;
 
   #include "background.inl"
 };
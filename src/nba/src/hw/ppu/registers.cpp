@@ -186,6 +186,10 @@ void WindowRange::Write(int address, u8 value) {
       min = value;
       break;
   }
+
+  if(ppu) {
+    ppu->DrawWindow();
+  }
 }
 
 auto WindowRange::ReadHalf() -> u16 {
@@ -112,6 +112,9 @@ struct WindowRange {
 
   auto ReadHalf() -> u16;
   void WriteHalf(u16 value);
+
+  // Only set for WINxH, since the window masks must be regenerated when it changes.
+  PPU* ppu = nullptr;
 };
 
 struct WindowLayerSelect {
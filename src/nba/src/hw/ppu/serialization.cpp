@@ -65,8 +65,17 @@ void PPU::LoadState(SaveState const& state) {
   std::memcpy(oam,  state.bus.memory.oam,  0x400);
   std::memcpy(vram, state.bus.memory.vram, 0x18000);
 
+  InvalidateSpriteLineMasks();
+
   vram_bg_latch = ss_ppu.vram_bg_latch;
   dma3_video_transfer_running = ss_ppu.dma3_video_transfer_running;
+
+  // The internal PPU state is not restored, so we cannot safely assume that the PPU is idle.
+  idle = false;
+
+  skip_frame = false;
+  present_output = true;
+  have_last_frame_hash = false;
 }
 
 void PPU::CopyState(SaveState& state) {
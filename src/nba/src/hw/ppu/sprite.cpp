@@ -11,6 +11,13 @@
 
 namespace nba::core {
 
+static constexpr int k_sprite_size[4][4][2] = {
+  { { 8 , 8  }, { 16, 16 }, { 32, 32 }, { 64, 64 } }, // Square
+  { { 16, 8  }, { 32, 8  }, { 32, 16 }, { 64, 32 } }, // Horizontal
+  { { 8 , 16 }, { 8 , 32 }, { 16, 32 }, { 32, 64 } }, // Vertical
+  { { 8 , 8  }, { 8 , 8  }, { 8 , 8  }, { 8 , 8  } }  // Prohibited
+};
+
 void PPU::InitSprite() {
   const uint vcount = mmio.vcount;
   const u64 timestamp_now = scheduler.GetTimestampNow();
@@ -53,11 +60,63 @@ void PPU::DrawSprite() {
 void PPU::DrawSpriteImpl(int cycles) {
   const uint cycle_limit = sprite.latch_cycle_limit;
 
+  auto& oam_fetch = sprite.oam_fetch;
+
+  if(sprite.dirty_mask[0] | sprite.dirty_mask[1]) {
+    UpdateSpriteLineMasks();
+  }
+
+  const bool enable_obj = mmio.dispcnt.enable[LAYER_OBJ];
+
   for(int i = 0; i < cycles; i++) {
     const uint cycle = sprite.cycle;
 
+    /**
+     * If the OBJ layer is disabled or all OAM entries were processed and the drawer unit is idle,
+     * there will be no further OAM or VRAM accesses. Skip ahead to cycle 1192 or the end of the scanline.
+     */
+    if(!enable_obj || (!sprite.drawing && (oam_fetch.step == 6 || (oam_fetch.step == 0 && oam_fetch.index == 128U)))) {
+      const uint cycle_end = std::min(cycle + (uint)(cycles - i), cycle_limit);
+      const uint skip = (cycle <= 1192U ? std::min(cycle_end, 1192U) : cycle_end) - cycle;
+
+      if(skip > 0U) {
+        sprite.cycle += skip;
+        i += (int)skip - 1;
+
+        if(sprite.cycle == cycle_limit) {
+          break;
+        }
+        continue;
+      }
+    }
+
     // @todo: research how real HW handles the OBJ layer enable bit
-    if(mmio.dispcnt.enable[LAYER_OBJ] && (cycle & 1U) == 0U) {
+    if(enable_obj && (cycle & 1U) == 0U) {
+      /**
+       * While the drawer unit is idle, OAM entries which are not visible on the scanline are rejected
+       * at a rate of one entry every two cycles, without any other side effects than the OAM access.
+       * This lets us skip over runs of such entries at once (stopping short of cycle 1192, see below).
+       */
+      if(!sprite.drawing && oam_fetch.step == 0 && oam_fetch.wait == 0 && cycle < 1192U) {
+        const uint max_entries = std::min((uint)(cycles - i) >> 1, (std::min(cycle_limit, 1192U) - cycle) >> 1);
+        const uint entries = std::min(FindNextVisibleSprite(oam_fetch.index) - oam_fetch.index, max_entries);
+
+        if(entries > 0U) {
+          sprite.timestamp_oam_access = sprite.timestamp_init + cycle + (entries - 1U) * 2U;
+
+          oam_fetch.index += entries;
+          oam_fetch.delay_wait = false;
+
+          sprite.cycle += entries * 2U;
+          i += (int)entries * 2 - 1;
+
+          if(sprite.cycle == cycle_limit) {
+            break;
+          }
+          continue;
+        }
+      }
+
       DrawSpriteFetchVRAM(cycle);
       DrawSpriteFetchOAM(cycle);
     }
@@ -83,13 +142,6 @@ void PPU::DrawSpriteImpl(int cycles) {
 }
 
 void PPU::DrawSpriteFetchOAM(uint cycle) {
-  static constexpr int k_sprite_size[4][4][2] = {
-    { { 8 , 8  }, { 16, 16 }, { 32, 32 }, { 64, 64 } }, // Square
-    { { 16, 8  }, { 32, 8  }, { 32, 16 }, { 64, 32 } }, // Horizontal
-    { { 8 , 16 }, { 8 , 32 }, { 16, 32 }, { 32, 64 } }, // Vertical
-    { { 8 , 8  }, { 8 , 8  }, { 8 , 8  }, { 8 , 8  } }  // Prohibited
-  };
-
   auto& oam_fetch = sprite.oam_fetch;
 
   if(oam_fetch.wait > 0 && !oam_fetch.delay_wait) {
@@ -127,7 +179,10 @@ void PPU::DrawSpriteFetchOAM(uint cycle) {
 
       bool active = false;
 
-      if((attr01 & 0x300U) != 0x200U) { // check if the sprite is enabled
+      const uint index = oam_fetch.index;
+
+      // check if the sprite is enabled and visible on this scanline
+      if(sprite.line_mask[sprite.vcount][index >> 6] & (1ULL << (index & 63U))) {
         const uint mode = (attr01 >> 10) & 3U;
 
         // @todo: how does HW handle OBJs in prohibited mode?
@@ -268,6 +323,85 @@ void PPU::DrawSpriteFetchOAM(uint cycle) {
   }
 }
 
+void PPU::InvalidateSpriteLineMasks() {
+  sprite.dirty_mask[0] = ~0ULL;
+  sprite.dirty_mask[1] = ~0ULL;
+}
+
+void PPU::UpdateSpriteLineMasks() {
+  for(uint index = 0; index < 128U; index++) {
+    const int word = index >> 6;
+    const u64 bit = 1ULL << (index & 63U);
+
+    if((sprite.dirty_mask[word] & bit) == 0U) {
+      continue;
+    }
+
+    // This must be kept in sync with the visibility checks in DrawSpriteFetchOAM()
+    const u32 attr01 = read<u32>(oam, index * 8U);
+    const uint mode = (attr01 >> 10) & 3U;
+
+    bool visible = (attr01 & 0x300U) != 0x200U && mode != OBJ_PROHIBITED;
+
+    s32 x = (attr01 >> 16) & 0x1FF;
+    s32 y =  attr01 & 0xFF;
+
+    if(x >= 240) x -= 512;
+
+    const uint shape = (attr01 >> 14) & 3U;
+    const uint size  =  attr01 >> 30;
+
+    int half_width  = k_sprite_size[shape][size][0] >> 1;
+    int half_height = k_sprite_size[shape][size][1] >> 1;
+
+    const bool affine = attr01 & 0x100U;
+
+    if(affine && (attr01 & 0x200U)) {
+      half_width  *= 2;
+      half_height *= 2;
+    }
+
+    const int y_max = (y + half_height * 2) & 255;
+
+    if(x < 0) {
+      const int clip = -x & (affine ? ~0 : ~1);
+
+      if(half_width * 2 - clip <= 0) {
+        visible = false;
+      }
+    }
+
+    for(int vcount = 0; vcount < 160; vcount++) {
+      if(visible && (vcount >= y || y_max < y) && vcount < y_max) {
+        sprite.line_mask[vcount][word] |= bit;
+      } else {
+        sprite.line_mask[vcount][word] &= ~bit;
+      }
+    }
+  }
+
+  sprite.dirty_mask[0] = 0U;
+  sprite.dirty_mask[1] = 0U;
+}
+
+auto PPU::FindNextVisibleSprite(uint index) -> uint {
+  const u64* line_mask = sprite.line_mask[sprite.vcount];
+
+  while(index < 128U) {
+    const u64 bits = line_mask[index >> 6] >> (index & 63U);
+
+    if(bits == 0U) {
+      index = (index | 63U) + 1U;
+    } else if(bits & 1U) {
+      break;
+    } else {
+      index++;
+    }
+  }
+
+  return index;
+}
+
 void PPU::DrawSpriteFetchVRAM(uint cycle) {
   if(!sprite.drawing) {
     return;
@@ -5,6 +5,8 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+
 #include "ppu.hpp"
 
 namespace nba::core {
@@ -12,6 +14,11 @@ namespace nba::core {
 void PPU::InitWindow() {
   const int vcount = mmio.vcount;
 
+  // Complete the previous scanline, so that we know the H-flags at the start of this scanline.
+  for(int i = 0; i < 2; i++) {
+    window.h_flag[i] = DrawWindowSpan(i, window.x, 256U, window.h_flag[i], false);
+  }
+
   for(int i = 0; i < 2; i++) {
     const auto& winv = mmio.winv[i];
 
@@ -24,46 +31,93 @@ void PPU::InitWindow() {
     }
   }
 
-  window.timestamp_last_sync = scheduler.GetTimestampNow();
-  window.cycle = 0;
+  window.timestamp_init = scheduler.GetTimestampNow();
+  window.x = 0U;
+
+  // The window masks are not needed during V-blank, but we still have to keep track of the H-flags.
+  const bool draw = vcount < 160;
+
+  for(int i = 0; i < 2; i++) {
+    window.h_min[i] = mmio.winh[i].min;
+    window.h_max[i] = mmio.winh[i].max;
+
+    if(draw) {
+      DrawWindowSpan(i, 0U, 256U, window.h_flag[i], true);
+    }
+  }
 }
 
 void PPU::DrawWindow() {
-  const u64 timestamp_now = scheduler.GetTimestampNow();
+  /**
+   * The window H-flags are evaluated once every four cycles (for X = 0 to 255).
+   * The window masks for the current scanline were already generated at the start of the scanline,
+   * so we only have to split the scanline at the current X-coordinate
+   * and regenerate the remaining part of it using the new WINxH values.
+   */
+  const u64 cycle = std::min<u64>(scheduler.GetTimestampNow() - window.timestamp_init, 1024U);
+  const uint x = std::max<uint>(window.x, ((uint)cycle + 3U) >> 2);
 
-  const int cycles = (int)(timestamp_now - window.timestamp_last_sync);
+  const bool draw = mmio.vcount < 160U;
 
-  if(cycles == 0 || window.cycle >= 1024U) {
-    return;
-  }
+  for(int i = 0; i < 2; i++) {
+    window.h_flag[i] = DrawWindowSpan(i, window.x, x, window.h_flag[i], false);
+    window.h_min[i] = mmio.winh[i].min;
+    window.h_max[i] = mmio.winh[i].max;
 
-  for(int i = 0; i < cycles; i++) {
-    if((window.cycle & 3U) == 0U) {
-      const uint x = window.cycle >> 2;
+    if(draw) {
+      DrawWindowSpan(i, x, 256U, window.h_flag[i], true);
+    }
+  }
 
-      for(int i = 0; i < 2; i++) {
-        const auto& winh = mmio.winh[i];
+  window.x = x;
+}
 
-        if(x == winh.min) {
-          window.h_flag[i] = true;
-        }
+auto PPU::DrawWindowSpan(int id, uint x_min, uint x_max, bool h_flag, bool draw) -> bool {
+  const uint h_min = window.h_min[id];
+  const uint h_max = window.h_max[id];
+  const bool v_flag = window.v_flag[id];
 
-        if(x == winh.max) {
-          window.h_flag[i] = false;
-        }
+  const auto Fill = [&](uint x0, uint x1, bool value) {
+    x0 = std::min(x0, 240U);
+    x1 = std::min(x1, 240U);
 
-        if(x < 240) {
-          window.buffer[x][i] = window.h_flag[i] && window.v_flag[i];
-        }
-      }
+    if(draw && x0 < x1) {
+      std::fill(&window.buffer[id][x0], &window.buffer[id][x1], value && v_flag);
     }
-
-    if(++window.cycle == 1024U) {
-      break;
+  };
+
+  const bool have_min = h_min >= x_min && h_min < x_max;
+  const bool have_max = h_max >= x_min && h_max < x_max;
+
+  // The H-flag is set when X reaches WINxH.min and cleared when it reaches WINxH.max (in that order).
+  if(have_min && have_max) {
+    if(h_min < h_max) {
+      Fill(x_min, h_min, h_flag);
+      Fill(h_min, h_max, true);
+      Fill(h_max, x_max, false);
+      return false;
     }
+
+    Fill(x_min, h_max, h_flag);
+    Fill(h_max, h_min, false);
+    Fill(h_min, x_max, h_min != h_max);
+    return h_min != h_max;
+  }
+
+  if(have_min) {
+    Fill(x_min, h_min, h_flag);
+    Fill(h_min, x_max, true);
+    return true;
+  }
+
+  if(have_max) {
+    Fill(x_min, h_max, h_flag);
+    Fill(h_max, x_max, false);
+    return false;
   }
 
-  window.timestamp_last_sync = timestamp_now;
+  Fill(x_min, x_max, h_flag);
+  return h_flag;
 }
 
 } // namespace nba::core
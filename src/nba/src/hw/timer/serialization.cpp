@@ -30,11 +30,27 @@ void Timer::LoadState(SaveState const& state) {
     channels[i].mask = g_ticks_mask[channels[i].control.frequency];
 
     channels[i].running = false;
+    channels[i].lazy_overflow = false;
     channels[i].event_overflow = scheduler.GetEventByUID(state.timer[i].event_uid);
 
     channels[i].pending.reload = state.timer[i].pending.reload;
     channels[i].pending.control = state.timer[i].pending.control;
   }
+
+  /**
+   * Restart the running timers, so that they continue counting from the saved counter and prescaler phase.
+   * This must happen after all channels were loaded, because a timer's overflows may depend on the next timer.
+   */
+  for(auto& channel : channels) {
+    if(channel.control.enable && !channel.control.cascade) {
+      if(channel.event_overflow) {
+        scheduler.Cancel(channel.event_overflow);
+        channel.event_overflow = nullptr;
+      }
+
+      StartChannel(channel, state.timer[channel.id].prescaler_phase);
+    }
+  }
 }
 
 void Timer::CopyState(SaveState& state) {
@@ -44,6 +60,7 @@ void Timer::CopyState(SaveState& state) {
     state.timer[i].control = ReadControl(channels[i]);
     state.timer[i].pending.reload = channels[i].pending.reload;
     state.timer[i].pending.control = channels[i].pending.control;
+    state.timer[i].prescaler_phase = channels[i].running ? (scheduler.GetTimestampNow() - channels[i].timestamp_started) & channels[i].mask : 0;
     state.timer[i].event_uid = GetEventUID(channels[i].event_overflow);
   }
 }
@@ -114,12 +114,17 @@ void Timer::WriteWord(int chan_id, u32 value) {
 }
 
 auto Timer::ReadCounter(Channel const& channel) -> u16 {
-  auto counter = channel.counter;
+  u64 counter = channel.counter;
 
   // While the timer is still running we must account for time that has passed
   // since the last counter update (overflow or configuration change).
   if(channel.running) {
     counter += GetCounterDeltaSinceLastUpdate(channel);
+
+    // Lazy overflows do not update the counter, so we must account for them here.
+    if(channel.lazy_overflow && counter >= 0x10000) {
+      counter = channel.reload + (counter - 0x10000) % (0x10000 - channel.reload);
+    }
   }
 
   return counter;
@@ -147,7 +152,18 @@ void Timer::WriteControl(Channel& channel, u16 value) {
 }
 
 void Timer::OnReloadWritten(u64 chan_id) {
-  channels[chan_id].reload = channels[chan_id].pending.reload;
+  auto& channel = channels[chan_id];
+
+  if(channel.running && channel.lazy_overflow) {
+    // Lazy overflows before the write still reload the old value.
+    CatchUpLazyOverflows(channel);
+    channel.reload = channel.pending.reload;
+
+    // Let the APU know about the new overflow interval.
+    RestartChannel(channel);
+  } else {
+    channel.reload = channel.pending.reload;
+  }
 }
 
 void Timer::OnControlWritten(u64 chan_id) {
@@ -196,29 +212,97 @@ void Timer::OnControlWritten(u64 chan_id) {
       }
     }
   }
+
+  // The previous timer must schedule its overflows as events, if they are counted by this timer.
+  if(channel.id != 0) {
+    auto& previous_channel = channels[channel.id - 1];
+
+    if(previous_channel.running && previous_channel.lazy_overflow == NeedsOverflowEvent(previous_channel)) {
+      RestartChannel(previous_channel);
+    }
+  }
 }
 
-auto Timer::GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u32 {
+auto Timer::GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u64 {
   return (scheduler.GetTimestampNow() - channel.timestamp_started) >> channel.shift;
 }
 
+bool Timer::NeedsOverflowEvent(Channel const& channel) {
+  if(channel.control.interrupt) {
+    return true;
+  }
+
+  if(channel.id != 3) {
+    auto const& next_channel = channels[channel.id + 1];
+
+    return next_channel.control.enable && next_channel.control.cascade;
+  }
+
+  return false;
+}
+
+void Timer::CatchUpLazyOverflows(Channel& channel) {
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+  const u64 timestamp_overflow = channel.timestamp_started + ((u64)(0x10000 - channel.counter) << channel.shift);
+
+  if(timestamp_now >= timestamp_overflow) {
+    const u64 interval = (u64)(0x10000 - channel.reload) << channel.shift;
+
+    channel.counter = channel.reload;
+    channel.timestamp_started = timestamp_overflow + (timestamp_now - timestamp_overflow) / interval * interval;
+  }
+}
+
 void Timer::StartChannel(Channel& channel, int cycle_offset) {
   int cycles = int((0x10000 - channel.counter) << channel.shift) - cycle_offset;
 
   channel.running = true;
   channel.timestamp_started = scheduler.GetTimestampNow() - cycle_offset;
-  channel.event_overflow = scheduler.Add(cycles, Scheduler::EventClass::TM_overflow, 0, channel.id);
+
+  /**
+   * Overflows that neither raise an IRQ nor clock a cascaded timer are not scheduled as events.
+   * Timers 0 and 1 report them to the APU instead, which consumes the FIFO samples lazily.
+   */
+  channel.lazy_overflow = !NeedsOverflowEvent(channel);
+
+  if(channel.lazy_overflow) {
+    if(channel.id <= 1) {
+      const u64 interval = (u64)(0x10000 - channel.reload) << channel.shift;
+
+      apu.StartLazyTimerOverflows(channel.id, scheduler.GetTimestampNow() + cycles, interval);
+    }
+  } else {
+    channel.event_overflow = scheduler.Add(cycles, Scheduler::EventClass::TM_overflow, 0, channel.id);
+  }
 }
 
 void Timer::StopChannel(Channel& channel) {
+  if(channel.lazy_overflow) {
+    CatchUpLazyOverflows(channel);
+
+    if(channel.id <= 1) {
+      apu.StopLazyTimerOverflows(channel.id);
+    }
+  }
+
   channel.counter += GetCounterDeltaSinceLastUpdate(channel);
   if(channel.counter >= 0x10000) {
     ReloadCascadeAndRequestIRQ(channel);
   }
 
-  scheduler.Cancel(channel.event_overflow);
-  channel.event_overflow = nullptr;
+  if(channel.event_overflow) {
+    scheduler.Cancel(channel.event_overflow);
+    channel.event_overflow = nullptr;
+  }
   channel.running = false;
+  channel.lazy_overflow = false;
+}
+
+void Timer::RestartChannel(Channel& channel) {
+  const int cycle_offset = (scheduler.GetTimestampNow() - channel.timestamp_started) & channel.mask;
+
+  StopChannel(channel);
+  StartChannel(channel, cycle_offset);
 }
 
 void Timer::ReloadCascadeAndRequestIRQ(Channel& channel) {
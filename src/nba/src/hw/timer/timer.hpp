@@ -55,6 +55,7 @@ private:
     } control = {};
 
     bool running = false;
+    bool lazy_overflow = false;
     int shift;
     int mask;
     int samplerate;
@@ -75,9 +76,12 @@ private:
   void OnReloadWritten(u64 chan_id);
   void OnControlWritten(u64 chan_id);
 
-  auto GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u32;
+  auto GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u64;
+  bool NeedsOverflowEvent(Channel const& channel);
+  void CatchUpLazyOverflows(Channel& channel);
   void StartChannel(Channel& channel, int cycle_offset);
   void StopChannel(Channel& channel);
+  void RestartChannel(Channel& channel);
   void ReloadCascadeAndRequestIRQ(Channel& channel);
   void OnOverflow(u64 chan_id);
 };
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <nba/config.hpp>
+#include <platform/frame_limiter.hpp>
 #include <string>
 #include <toml.hpp>
 
@@ -16,6 +17,7 @@ namespace nba {
 struct PlatformConfig : Config {
   std::string bios_path = "bios.bin";
   std::string save_folder = "";
+  FrameLimiter::Mode frame_limiter_mode = FrameLimiter::Mode::Hybrid;
   
   struct Cartridge {
     BackupType backup_type = BackupType::Detect;
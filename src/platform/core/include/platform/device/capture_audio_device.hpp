@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <nba/device/audio_device.hpp>
+#include <nba/integer.hpp>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * Audio device that captures the emulator's audio output to a WAV or raw PCM file.
+ *
+ * Instead of being driven by a sound card, the audio callback is invoked from Advance(),
+ * which the emulator thread calls with the number of cycles that it emulated
+ * (for example Advance(CoreBase::kCyclesPerFrame) after every call to RunForOneFrame()).
+ * The captured audio thus only depends on the emulation and not on real-time pacing,
+ * which makes it suitable for recording and for comparing audio output between runs.
+ *
+ * Encoded samples are handed to a writer thread through a bounded queue.
+ * If the writer thread falls behind, Advance() blocks until there is room in the queue, so that no samples are dropped.
+ */
+struct CaptureAudioDevice : AudioDevice {
+  enum class Container {
+    WAV,
+    Raw
+  };
+
+  CaptureAudioDevice(fs::path const& path, Container container = Container::WAV);
+ ~CaptureAudioDevice() override;
+
+  void SetSampleRate(int sample_rate);
+  void SetSampleFormat(SampleFormat sample_format);
+  void Advance(int cycles);
+
+  auto GetSampleRate() -> int final;
+  auto GetBlockSize() -> int final;
+  auto GetSampleFormat() -> SampleFormat final;
+  auto GetUnderrunMode() -> UnderrunMode final;
+  bool Open(void* userdata, Callback callback) final;
+  void SetPause(bool value) final;
+  void Close() final;
+
+private:
+  static constexpr int k_cycles_per_second = 16777216;
+  static constexpr int k_block_size = 2048;
+  static constexpr int k_max_queued_chunks = 64;
+
+  void Pull(int samples);
+  void StartWriter();
+  void StopWriter();
+  void WriterLoop();
+  void WriteWAVHeader();
+
+  fs::path path;
+  Container container;
+  int sample_rate = 48000;
+  SampleFormat sample_format = SampleFormat::S16;
+
+  Callback callback = nullptr;
+  void* callback_userdata = nullptr;
+  u64 cycles = 0;
+  u64 samples_pulled = 0;
+  std::vector<u8> stream;
+
+  std::ofstream file;
+  u64 data_size = 0;
+
+  std::thread writer_thread;
+  std::mutex queue_mutex;
+  std::condition_variable queue_cv;
+  std::deque<std::vector<u8>> queue;
+  bool writer_running = false;
+};
+
+} // namespace nba
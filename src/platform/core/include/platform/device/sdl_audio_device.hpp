@@ -16,11 +16,13 @@ namespace nba {
 struct SDL2_AudioDevice : AudioDevice {
   void SetSampleRate(int sample_rate);
   void SetBlockSize(int buffer_size);
+  void SetSampleFormat(SampleFormat sample_format);
   void SetPassthrough(SDL_AudioCallback passthrough);
   void InvokeCallback(s16* stream, int byte_len);
 
   auto GetSampleRate() -> int final;
   auto GetBlockSize() -> int final;
+  auto GetSampleFormat() -> SampleFormat final;
   bool Open(void* userdata, Callback callback) final;
   void SetPause(bool value) final;
   void Close() final;
@@ -33,6 +35,7 @@ private:
   SDL_AudioSpec have;
   int want_sample_rate = 48000;
   int want_block_size = 2048;
+  SampleFormat want_sample_format = SampleFormat::F32;
   bool opened = false;
   bool paused = false;
 };
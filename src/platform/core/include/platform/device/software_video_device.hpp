@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <nba/device/video_device.hpp>
+#include <nba/integer.hpp>
+#include <platform/config.hpp>
+#include <thread>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Video device that implements the post-processing of the OGLVideoDevice on the CPU,
+ * for hosts without a GPU (for example for recording or streaming on a server).
+ *
+ * The color correction, LCD ghosting and output filter settings are honoured just like by the shader pipeline
+ * and the output closely matches it. Every pass is split into bands of rows, which are processed in parallel
+ * by a small pool of worker threads. By default at most k_default_thread_count threads are used
+ * (including the thread calling Draw()), so that the device does not compete with the emulator thread
+ * and the host for every core. Hosts that render at large output sizes may pass a larger thread_count.
+ *
+ * The device processes frames on the thread that calls Draw(). Once a frame is done, the frame callback
+ * is invoked with the processed frame (in ARGB8888 format), which is also available via GetOutput() until the next frame.
+ * ReloadConfig() and SetOutputSize() must not be called concurrently with Draw().
+ */
+struct SoftwareVideoDevice : VideoDevice {
+  using FrameCallback = std::function<void(u32 const* frame, int width, int height)>;
+
+  static constexpr int k_default_thread_count = 4;
+
+  SoftwareVideoDevice(
+    std::shared_ptr<PlatformConfig> config,
+    int width = 240,
+    int height = 160,
+    int thread_count = 0
+  );
+
+ ~SoftwareVideoDevice() override;
+
+  void SetOutputSize(int width, int height);
+  void SetFrameCallback(FrameCallback callback);
+  void ReloadConfig();
+
+  auto GetOutputWidth() const -> int { return output_width; }
+  auto GetOutputHeight() const -> int { return output_height; }
+  auto GetOutput() const -> u32 const* { return output.data(); }
+
+  void Draw(u32* buffer) override;
+
+private:
+  using Video = PlatformConfig::Video;
+
+  struct Color {
+    float r;
+    float g;
+    float b;
+  };
+
+  /**
+   * Source texels of an output column or row.
+   * For bilinear filtering the second texel is weighted with an 8-bit fixed-point weight,
+   * for the xBRZ filter the position of the output pixel relative to the texel center is stored.
+   */
+  struct Tap {
+    int index[2];
+    int weight;
+    float offset;
+  };
+
+  void UpdateColorLUT();
+  void UpdateTaps();
+  void ResetHistory();
+
+  void ApplyColorCorrection(u32 const* buffer, int y_min, int y_max);
+  void ApplyNearest(int y_min, int y_max);
+  void ApplyBilinear(int y_min, int y_max);
+  void ApplyXBRZAnalysis(int y_min, int y_max);
+  void ApplyXBRZ(int y_min, int y_max);
+
+  static auto DistYCbCr(Color const& a, Color const& b) -> float;
+
+  void ParallelFor(int count, std::function<void(int, int)> const& task);
+  void WorkerLoop(int index);
+
+  std::shared_ptr<PlatformConfig> config;
+  Video video;
+
+  int output_width;
+  int output_height;
+  std::vector<u32> output;
+  FrameCallback frame_callback;
+
+  // Color-corrected (and possibly ghosted) input frame
+  std::vector<u32> frame;
+
+  // Previous output of the LCD ghosting pass. Output-sized if the xBRZ filter is used.
+  std::vector<u32> history;
+
+  // Indexed by RGB555 color, which the ARGB8888 frames from the PPU are expanded from without loss.
+  std::array<u32, 32768> color_lut;
+
+  std::vector<Tap> taps_x;
+  std::vector<Tap> taps_y;
+
+  // Lcd1x filter brightness per output column and row, as 8-bit fixed-point factors.
+  std::vector<int> shade_x;
+  std::vector<int> shade_y;
+
+  // xBRZ filter: input frame as floating-point colors and the edge information from the first pass.
+  std::vector<Color> xbrz_colors;
+  std::vector<u32> xbrz_info;
+
+  // Number of bands of rows that each pass is split into, one per thread.
+  int band_count = 1;
+  std::vector<std::thread> workers;
+  std::mutex job_mutex;
+  std::condition_variable job_cv;
+  std::condition_variable job_done_cv;
+  std::function<void(int, int)> const* job_task = nullptr;
+  int job_count = 0;
+  int job_pending = 0;
+  u64 job_generation = 0;
+  bool workers_quit = false;
+};
+
+} // namespace nba
@@ -9,12 +9,12 @@
 
 #include <atomic>
 #include <functional>
+#include <future>
+#include <nba/common/mpsc_queue.hpp>
 #include <nba/core.hpp>
 #include <nba/integer.hpp>
 #include <platform/frame_limiter.hpp>
 #include <thread>
-#include <queue>
-#include <mutex>
 
 namespace nba {
 
@@ -27,7 +27,8 @@ struct EmulatorThread {
   void SetPause(bool value);
   bool GetFastForward() const;
   void SetFastForward(bool enabled);
-  void SetFrameRateCallback(std::function<void(float)> callback);
+  void SetFrameLimiterMode(FrameLimiter::Mode mode);
+  void SetFrameRateCallback(std::function<void(float, FrameLimiter::Statistics const&)> callback);
   void SetPerFrameCallback(std::function<void()> callback);
 
   void Start(std::unique_ptr<CoreBase> core);
@@ -35,11 +36,22 @@ struct EmulatorThread {
 
   void Reset();
   void SetKeyStatus(Key key, bool pressed);
+  void SetFrameSkip(int frameskip);
+
+  /**
+   * Loads or copies the emulator state in between two subframes.
+   * CopyState() returns no state if the emulator thread is not running.
+   */
+  void LoadState(std::unique_ptr<SaveState> state);
+  auto CopyState() -> std::future<std::unique_ptr<SaveState>>;
 
 private:
   enum class MessageType : u8 {
     Reset,
-    SetKeyStatus
+    SetKeyStatus,
+    SetFrameSkip,
+    LoadState,
+    CopyState
   };
 
   struct Message {
@@ -49,12 +61,23 @@ private:
         Key key;
         u8bool pressed;
       } set_key_status;
+      struct {
+        int frameskip;
+      } set_frame_skip;
+      // The message owns the following objects:
+      struct {
+        SaveState* state;
+      } load_state;
+      struct {
+        std::promise<std::unique_ptr<SaveState>>* promise;
+      } copy_state;
     };
   };
 
   void PushMessage(const Message& message);
   void ProcessMessages();
   void ProcessMessage(const Message& message);
+  void DiscardMessage(const Message& message);
 
   static constexpr int k_number_of_input_subframes = 4;
   static constexpr int k_cycles_per_second = 16777216;
@@ -63,15 +86,17 @@ private:
 
   static_assert(k_cycles_per_frame % k_number_of_input_subframes == 0);
 
-  std::queue<Message> msg_queue;
-  std::mutex msg_queue_mutex;
+  static constexpr int k_message_queue_capacity = 256;
+
+  MPSCQueue<Message, k_message_queue_capacity> msg_queue;
 
   std::unique_ptr<CoreBase> core;
   FrameLimiter frame_limiter;
+  std::atomic<FrameLimiter::Mode> frame_limiter_mode = FrameLimiter::Mode::Hybrid;
   std::thread thread;
   std::atomic_bool running = false;
   bool paused = false;
-  std::function<void(float)> frame_rate_cb = [](float) {};
+  std::function<void(float, FrameLimiter::Statistics const&)> frame_rate_cb = [](float, FrameLimiter::Statistics const&) {};
   std::function<void()> per_frame_cb = []() {};
 };
 
@@ -10,10 +10,30 @@
 #include <chrono>
 #include <functional>
 #include <thread>
+#include <vector>
 
 namespace nba {
 
 struct FrameLimiter {
+  enum class Mode {
+    // Sleep until the end of the frame. Cheap, but at the mercy of the OS timer resolution.
+    Sleep,
+    // Sleep until shortly before the end of the frame and then yield until the deadline.
+    Hybrid
+  };
+
+  /**
+   * Frame pacing statistics over the frames since the last FPS update, in milliseconds.
+   * The frame time is the time between the end of two consecutive frames,
+   * the lateness is how far past its deadline the limiter returned from a frame.
+   */
+  struct Statistics {
+    float frame_time_p50 = 0;
+    float frame_time_p99 = 0;
+    float lateness_p50 = 0;
+    float lateness_p99 = 0;
+  };
+
   FrameLimiter(float fps = 60.0) {
     Reset(fps);
   }
@@ -22,23 +42,40 @@ struct FrameLimiter {
   void Reset(float fps);
   auto GetFastForward() const -> bool;
   void SetFastForward(bool value);
+  auto GetMode() const -> Mode;
+  void SetMode(Mode mode);
 
   void Run(
     std::function<void(void)> frame_advance,
-    std::function<void(float)> update_fps
+    std::function<void(float, Statistics const&)> update_fps
   );
 
 private:
   static constexpr int kMillisecondsPerSecond = 1000;
   static constexpr int kMicrosecondsPerSecond = 1000000;
 
+  /**
+   * How long before the deadline the hybrid limiter stops sleeping.
+   * This should cover the typical wake-up latency of sleep_until().
+   */
+  static constexpr std::chrono::microseconds kSpinThreshold{1000};
+
+  void Wait();
+  auto GetStatistics() -> Statistics;
+
   int frame_count = 0;
   int frame_duration;
   float frames_per_second;
   bool fast_forward = false;
+  Mode mode = Mode::Hybrid;
 
   std::chrono::time_point<std::chrono::steady_clock> timestamp_target;
   std::chrono::time_point<std::chrono::steady_clock> timestamp_fps_update;
+  std::chrono::time_point<std::chrono::steady_clock> timestamp_frame_end;
+
+  // Frame times and lateness in microseconds, since the last FPS update.
+  std::vector<int> frame_times;
+  std::vector<int> lateness;
 };
 
 } // namespace nba
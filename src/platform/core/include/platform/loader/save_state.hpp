@@ -29,6 +29,11 @@ struct SaveStateLoader {
     fs::path const& path
   ) -> Result;
 
+  static auto Load(
+    fs::path const& path,
+    SaveState& save_state
+  ) -> Result;
+
 private:
   static auto Validate(SaveState const& save_state) -> Result;
 };
@@ -26,6 +26,11 @@ struct SaveStateWriter {
     std::unique_ptr<CoreBase>& core,
     fs::path const& path
   ) -> Result;
+
+  static auto Write(
+    SaveState const& save_state,
+    fs::path const& path
+  ) -> Result;
 };
 
 } // namespace nba
@@ -36,6 +36,17 @@ void PlatformConfig::Load(std::string const& path) {
       this->bios_path = toml::find_or<std::string>(general, "bios_path", "bios.bin");
       this->skip_bios = toml::find_or<toml::boolean>(general, "bios_skip", false);
       this->save_folder = toml::find_or<std::string>(general, "save_folder", "");
+
+      const std::map<std::string, FrameLimiter::Mode> frame_limiter_modes{
+        { "sleep",  FrameLimiter::Mode::Sleep  },
+        { "hybrid", FrameLimiter::Mode::Hybrid }
+      };
+
+      auto frame_limiter_mode = toml::find_or<std::string>(general, "frame_limiter", "hybrid");
+      auto frame_limiter_mode_match = frame_limiter_modes.find(frame_limiter_mode);
+      if(frame_limiter_mode_match != frame_limiter_modes.end()) {
+        this->frame_limiter_mode = frame_limiter_mode_match->second;
+      }
     }
   }
 
@@ -104,6 +115,7 @@ void PlatformConfig::Load(std::string const& path) {
       }
 
       this->video.lcd_ghosting = toml::find_or<bool>(video, "lcd_ghosting", true);
+      this->frameskip = toml::find_or<int>(video, "frameskip", 0);
     }
   }
 
@@ -158,6 +170,11 @@ void PlatformConfig::Save(std::string const& path) {
   data["general"]["bios_skip"] = this->skip_bios;
   data["general"]["save_folder"] = this->save_folder;
 
+  switch(this->frame_limiter_mode) {
+    case FrameLimiter::Mode::Sleep:  data["general"]["frame_limiter"] = "sleep"; break;
+    case FrameLimiter::Mode::Hybrid: data["general"]["frame_limiter"] = "hybrid"; break;
+  }
+
   // Cartridge
   std::string save_type;
   switch(this->cartridge.backup_type) {
@@ -195,6 +212,7 @@ void PlatformConfig::Save(std::string const& path) {
   data["video"]["filter"] = filter;
   data["video"]["color_correction"] = color_correction;
   data["video"]["lcd_ghosting"] = this->video.lcd_ghosting;
+  data["video"]["frameskip"] = this->frameskip;
 
   // Audio
   std::string resampler;
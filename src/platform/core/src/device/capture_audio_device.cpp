@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <nba/log.hpp>
+#include <platform/device/capture_audio_device.hpp>
+
+namespace nba {
+
+CaptureAudioDevice::CaptureAudioDevice(fs::path const& path, Container container)
+    : path(path)
+    , container(container) {
+}
+
+CaptureAudioDevice::~CaptureAudioDevice() {
+  Close();
+}
+
+void CaptureAudioDevice::SetSampleRate(int sample_rate) {
+  this->sample_rate = sample_rate;
+}
+
+void CaptureAudioDevice::SetSampleFormat(SampleFormat sample_format) {
+  this->sample_format = sample_format;
+}
+
+void CaptureAudioDevice::Advance(int cycles) {
+  if(callback == nullptr) {
+    return;
+  }
+
+  /**
+   * The emulator's sample buffer is kept about half full by dynamic rate control.
+   * Reading behind the emulation by that amount makes sure that the samples we read were already produced
+   * and that the buffer never overflows.
+   */
+  const u64 latency = GetBlockSize() * k_buffered_blocks / 2;
+
+  this->cycles += cycles;
+
+  const u64 samples_due = this->cycles * sample_rate / k_cycles_per_second;
+
+  if(samples_due > samples_pulled + latency) {
+    Pull((int)(samples_due - latency - samples_pulled));
+  }
+}
+
+void CaptureAudioDevice::Pull(int samples) {
+  const int sample_size = sample_format == SampleFormat::F32 ? sizeof(float) : sizeof(s16);
+  const int byte_len = samples * 2 * sample_size;
+
+  samples_pulled += samples;
+
+  stream.resize(byte_len);
+  callback(callback_userdata, (s16*)stream.data(), byte_len);
+
+  {
+    std::unique_lock lock{queue_mutex};
+
+    queue_cv.wait(lock, [this]() { return (int)queue.size() < k_max_queued_chunks; });
+    queue.push_back(std::move(stream));
+  }
+
+  queue_cv.notify_all();
+}
+
+auto CaptureAudioDevice::GetSampleRate() -> int {
+  return sample_rate;
+}
+
+auto CaptureAudioDevice::GetBlockSize() -> int {
+  return k_block_size;
+}
+
+auto CaptureAudioDevice::GetSampleFormat() -> SampleFormat {
+  return sample_format;
+}
+
+auto CaptureAudioDevice::GetUnderrunMode() -> UnderrunMode {
+  // Repeated samples would end up in the capture. Missing samples are captured as silence instead.
+  return UnderrunMode::Silence;
+}
+
+bool CaptureAudioDevice::Open(void* userdata, Callback callback) {
+  /**
+   * The APU closes and reopens the device when the emulator is reset.
+   * The file stays open in that case, so that the capture continues where it left off.
+   */
+  if(!file.is_open()) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+
+    if(!file.good()) {
+      Log<Error>("Audio: failed to open capture file: {0}", path.string());
+      return false;
+    }
+
+    data_size = 0;
+
+    if(container == Container::WAV) {
+      WriteWAVHeader();
+    }
+  }
+
+  this->callback = callback;
+  callback_userdata = userdata;
+  cycles = 0;
+  samples_pulled = 0;
+
+  StartWriter();
+  return true;
+}
+
+void CaptureAudioDevice::SetPause(bool value) {
+  // Nothing to do: the capture only advances together with the emulation.
+}
+
+void CaptureAudioDevice::Close() {
+  /**
+   * Advance() lags behind the emulation, so the samples for the last few milliseconds are still buffered.
+   * The emulator is about to release the buffer (when it is reset or destroyed), so pull them now.
+   * The emulator flushes its mixer before closing the device, but samples that are still held back by the resampler
+   * were never buffered, so the end of the capture may be padded with a few samples of silence.
+   */
+  if(callback != nullptr) {
+    const u64 samples_due = cycles * sample_rate / k_cycles_per_second;
+
+    if(samples_due > samples_pulled) {
+      Pull((int)(samples_due - samples_pulled));
+    }
+  }
+
+  callback = nullptr;
+
+  StopWriter();
+
+  // Keep the WAV header up-to-date, so that the file is valid even if the capture is not continued.
+  if(file.is_open() && container == Container::WAV) {
+    WriteWAVHeader();
+  }
+}
+
+void CaptureAudioDevice::StartWriter() {
+  if(writer_running) {
+    return;
+  }
+
+  writer_running = true;
+  writer_thread = std::thread{[this]() { WriterLoop(); }};
+}
+
+void CaptureAudioDevice::StopWriter() {
+  if(!writer_running) {
+    return;
+  }
+
+  {
+    std::lock_guard guard{queue_mutex};
+    writer_running = false;
+  }
+
+  queue_cv.notify_all();
+  writer_thread.join();
+}
+
+void CaptureAudioDevice::WriterLoop() {
+  while(true) {
+    std::vector<u8> chunk;
+
+    {
+      std::unique_lock lock{queue_mutex};
+
+      queue_cv.wait(lock, [this]() { return !queue.empty() || !writer_running; });
+
+      // Drain the queue completely before stopping.
+      if(queue.empty()) {
+        break;
+      }
+
+      chunk = std::move(queue.front());
+      queue.pop_front();
+    }
+
+    queue_cv.notify_all();
+
+    file.write((const char*)chunk.data(), chunk.size());
+    data_size += chunk.size();
+  }
+
+  file.flush();
+}
+
+void CaptureAudioDevice::WriteWAVHeader() {
+  const bool f32 = sample_format == SampleFormat::F32;
+  const int sample_size = f32 ? sizeof(float) : sizeof(s16);
+  const u32 data_length = (u32)std::min<u64>(data_size, std::numeric_limits<u32>::max() - 36);
+
+  u8 header[44];
+  int offset = 0;
+
+  const auto write_tag = [&](char const* tag) {
+    std::copy_n(tag, 4, &header[offset]);
+    offset += 4;
+  };
+
+  const auto write_int = [&](u32 value, int size) {
+    for(int i = 0; i < size; i++) {
+      header[offset++] = (u8)(value >> (i * 8));
+    }
+  };
+
+  write_tag("RIFF");
+  write_int(36 + data_length, 4);
+  write_tag("WAVE");
+  write_tag("fmt ");
+  write_int(16, 4);
+  write_int(f32 ? 3 : 1, 2); // IEEE float or integer PCM
+  write_int(2, 2); // channels
+  write_int(sample_rate, 4);
+  write_int(sample_rate * 2 * sample_size, 4); // bytes per second
+  write_int(2 * sample_size, 2); // bytes per frame
+  write_int(sample_size * 8, 2); // bits per sample
+  write_tag("data");
+  write_int(data_length, 4);
+
+  const auto position = file.tellp();
+
+  file.seekp(0);
+  file.write((const char*)header, sizeof(header));
+
+  if(position > 0) {
+    file.seekp(position);
+  }
+
+  file.flush();
+}
+
+} // namespace nba
@@ -18,6 +18,10 @@ void SDL2_AudioDevice::SetBlockSize(int block_size) {
   want_block_size = block_size;
 }
 
+void SDL2_AudioDevice::SetSampleFormat(SampleFormat sample_format) {
+  want_sample_format = sample_format;
+}
+
 void SDL2_AudioDevice::SetPassthrough(SDL_AudioCallback passthrough) {
   this->passthrough = passthrough;
 }
@@ -36,6 +40,10 @@ auto SDL2_AudioDevice::GetBlockSize() -> int {
   return have.samples;
 }
 
+auto SDL2_AudioDevice::GetSampleFormat() -> SampleFormat {
+  return have.format == AUDIO_F32 ? SampleFormat::F32 : SampleFormat::S16;
+}
+
 bool SDL2_AudioDevice::Open(void* userdata, Callback callback) {
   auto want = SDL_AudioSpec{};
 
@@ -46,7 +54,8 @@ bool SDL2_AudioDevice::Open(void* userdata, Callback callback) {
 
   want.freq = want_sample_rate;
   want.samples = want_block_size;
-  want.format = AUDIO_S16;
+  // With F32 the emulator skips the conversion to S16. SDL converts to the native format if necessary.
+  want.format = want_sample_format == SampleFormat::F32 ? AUDIO_F32 : AUDIO_S16;
   want.channels = 2;
 
   if(passthrough != nullptr) {
@@ -70,7 +79,7 @@ bool SDL2_AudioDevice::Open(void* userdata, Callback callback) {
   opened = true;
 
   if(have.format != want.format) {
-    Log<Error>("Audio: SDL_AudioDevice: S16 sample format unavailable.");
+    Log<Error>("Audio: SDL_AudioDevice: requested sample format unavailable.");
     return false;
   }
 
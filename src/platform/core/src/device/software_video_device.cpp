@@ -0,0 +1,740 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <platform/device/software_video_device.hpp>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace nba {
+
+static constexpr int gba_screen_width  = 240;
+static constexpr int gba_screen_height = 160;
+
+static constexpr float kPi = 3.141592653589793f;
+static constexpr float kSqrt2 = 1.4142135623730951f;
+
+// xBRZ filter parameters, see device/shader/xbrz.glsl.hpp
+static constexpr int kBlendNone = 0;
+static constexpr int kBlendNormal = 1;
+static constexpr int kBlendDominant = 2;
+static constexpr float kEqualColorTolerance = 30.0f / 255.0f;
+static constexpr float kSteepDirectionThreshold = 2.2f;
+static constexpr float kDominantDirectionThreshold = 3.6f;
+
+/**
+ * Interpolate between two ARGB8888 colors, given an 8-bit fixed-point weight of the second color.
+ * Two channels are interpolated at a time, which is why the weight may not exceed 256.
+ */
+static inline u32 Lerp(u32 a, u32 b, int weight) {
+  const u32 rb = ((a & 0xFF00FF) * (256 - weight) + (b & 0xFF00FF) * weight + 0x800080) >> 8;
+  const u32 ag = (((a >> 8) & 0xFF00FF) * (256 - weight) + ((b >> 8) & 0xFF00FF) * weight + 0x800080) >> 8;
+
+  return (rb & 0xFF00FF) | ((ag & 0xFF00FF) << 8);
+}
+
+// Scale the RGB channels of an ARGB8888 color by an 8-bit fixed-point factor (at most 256) and make it opaque.
+static inline u32 Shade(u32 color, int factor) {
+  const u32 rb = ((color & 0xFF00FF) * factor + 0x800080) >> 8;
+  const u32 g  = ((color & 0x00FF00) * factor + 0x008000) >> 8;
+
+  return 0xFF000000 | (rb & 0xFF00FF) | (g & 0x00FF00);
+}
+
+/**
+ * LCD ghosting: blend the buffer with the previous output of this pass (50/50),
+ * which then becomes the history for the next frame.
+ */
+static void BlendWithHistory(u32* buffer, u32* history, int begin, int end) {
+  int i = begin;
+
+#if defined(__SSE2__)
+  for(; i + 4 <= end; i += 4) {
+    const __m128i a = _mm_loadu_si128((__m128i const*)&buffer[i]);
+    const __m128i b = _mm_loadu_si128((__m128i const*)&history[i]);
+    const __m128i blended = _mm_avg_epu8(a, b);
+
+    _mm_storeu_si128((__m128i*)&buffer[i], blended);
+    _mm_storeu_si128((__m128i*)&history[i], blended);
+  }
+#endif
+
+  // Per-byte (a + b + 1) >> 1, which is what _mm_avg_epu8() computes as well.
+  for(; i < end; i++) {
+    const u32 a = buffer[i];
+    const u32 b = history[i];
+
+    buffer[i] = history[i] = (a | b) - (((a ^ b) & 0xFEFEFEFE) >> 1);
+  }
+}
+
+SoftwareVideoDevice::SoftwareVideoDevice(
+  std::shared_ptr<PlatformConfig> config,
+  int width,
+  int height,
+  int thread_count
+) : config(config) {
+  frame.resize(gba_screen_width * gba_screen_height);
+  xbrz_colors.resize(gba_screen_width * gba_screen_height);
+  xbrz_info.resize(gba_screen_width * gba_screen_height);
+
+  output_width  = std::max(width, 1);
+  output_height = std::max(height, 1);
+  output.resize(output_width * output_height);
+
+  ReloadConfig();
+
+  if(thread_count <= 0) {
+    thread_count = std::min(k_default_thread_count, (int)std::thread::hardware_concurrency());
+  }
+
+  // The thread calling Draw() processes one band of rows itself.
+  band_count = std::max(thread_count, 1);
+
+  for(int i = 1; i < band_count; i++) {
+    workers.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+}
+
+SoftwareVideoDevice::~SoftwareVideoDevice() {
+  {
+    std::lock_guard lock{job_mutex};
+    workers_quit = true;
+  }
+  job_cv.notify_all();
+
+  for(auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void SoftwareVideoDevice::SetOutputSize(int width, int height) {
+  output_width  = std::max(width, 1);
+  output_height = std::max(height, 1);
+  output.resize(output_width * output_height);
+
+  UpdateTaps();
+  ResetHistory();
+}
+
+void SoftwareVideoDevice::SetFrameCallback(FrameCallback callback) {
+  frame_callback = std::move(callback);
+}
+
+void SoftwareVideoDevice::ReloadConfig() {
+  video = config->video;
+
+  UpdateColorLUT();
+  UpdateTaps();
+  ResetHistory();
+}
+
+void SoftwareVideoDevice::UpdateColorLUT() {
+  // Negative values would be NaN after pow() in the shaders, which the GPU writes out as zero.
+  const auto gamma = [](double value) {
+    return std::pow(std::max(value, 0.0), 1.0 / 2.2);
+  };
+
+  const auto to_u8 = [](double value) {
+    return (u32)std::lround(std::clamp(value, 0.0, 1.0) * 255.0);
+  };
+
+  for(int i = 0; i < 32768; i++) {
+    const auto expand = [](int value) {
+      return ((value << 3) | (value >> 2)) / 255.0;
+    };
+
+    double r = expand((i >> 10) & 31);
+    double g = expand((i >>  5) & 31);
+    double b = expand( i        & 31);
+
+    switch(video.color) {
+      case Video::Color::No: break;
+      case Video::Color::higan: {
+        const double r_in = std::pow(r, 4.0);
+        const double g_in = std::pow(g, 4.0);
+        const double b_in = std::pow(b, 4.0);
+
+        r = gamma(1.000 * r_in + 0.196 * g_in);
+        g = gamma(0.039 * r_in + 0.901 * g_in + 0.117 * b_in);
+        b = gamma(0.196 * r_in + 0.039 * g_in + 0.862 * b_in);
+        break;
+      }
+      case Video::Color::AGB: {
+        const double lum = 0.94;
+        const double r_in = std::clamp(std::pow(r, 3.2) * lum, 0.0, 1.0);
+        const double g_in = std::clamp(std::pow(g, 3.2) * lum, 0.0, 1.0);
+        const double b_in = std::clamp(std::pow(b, 3.2) * lum, 0.0, 1.0);
+
+        r = gamma(0.820 * r_in + 0.240 * g_in - 0.060 * b_in);
+        g = gamma(0.125 * r_in + 0.665 * g_in + 0.210 * b_in);
+        b = gamma(0.195 * r_in + 0.075 * g_in + 0.730 * b_in);
+        break;
+      }
+    }
+
+    color_lut[i] = 0xFF000000 | to_u8(r) << 16 | to_u8(g) << 8 | to_u8(b);
+  }
+}
+
+void SoftwareVideoDevice::UpdateTaps() {
+  const bool bilinear = video.filter == Video::Filter::Linear ||
+                        video.filter == Video::Filter::Sharp;
+
+  const auto update = [&](std::vector<Tap>& taps, std::vector<int>& shade, int input_size, int output_size, float brighten) {
+    const float scale = std::max(std::floor((float)output_size / input_size), 1.0f);
+    const float region_range = 0.5f - 0.5f / scale;
+
+    taps.resize(output_size);
+    shade.resize(output_size);
+
+    for(int i = 0; i < output_size; i++) {
+      auto& tap = taps[i];
+
+      // Position of the output pixel's center on the input, in texels.
+      const float center = (i + 0.5f) * input_size / output_size;
+
+      float texel = center;
+
+      if(bilinear) {
+        // Sharp bilinear: sample at an offset which is equivalent to bilinear filtering of the integer-upscaled input.
+        if(video.filter == Video::Filter::Sharp) {
+          const float center_dist = texel - std::floor(texel) - 0.5f;
+
+          texel = std::floor(texel) + (center_dist - std::clamp(center_dist, -region_range, region_range)) * scale + 0.5f;
+        }
+
+        const float position = texel - 0.5f;
+        const int index = (int)std::floor(position);
+
+        tap.index[0] = std::clamp(index, 0, input_size - 1);
+        tap.index[1] = std::clamp(index + 1, 0, input_size - 1);
+        tap.weight = (int)std::lround((position - index) * 256.0f);
+        tap.offset = 0.0f;
+      } else {
+        const int index = std::min((int)texel, input_size - 1);
+
+        tap.index[0] = index;
+        tap.index[1] = index;
+        tap.weight = 0;
+        tap.offset = texel - std::floor(texel) - 0.5f;
+      }
+
+      // Lcd1x filter: darken the pixel grid and the scanlines.
+      const float angle = 2.0f * kPi * (center - 0.25f);
+
+      shade[i] = (int)std::lround((brighten + std::sin(angle)) / (brighten + 1.0f) * 256.0f);
+    }
+  };
+
+  update(taps_x, shade_x, gba_screen_width,  output_width,  24.0f);
+  update(taps_y, shade_y, gba_screen_height, output_height, 16.0f);
+}
+
+void SoftwareVideoDevice::ResetHistory() {
+  if(video.filter == Video::Filter::xBRZ) {
+    history.assign(output_width * output_height, 0xFF000000);
+  } else {
+    history.assign(gba_screen_width * gba_screen_height, 0xFF000000);
+  }
+}
+
+void SoftwareVideoDevice::Draw(u32* buffer) {
+  const bool xbrz = video.filter == Video::Filter::xBRZ;
+
+  // Color correction pass. LCD ghosting is applied right away, unless it needs to be applied to the xBRZ output.
+  ParallelFor(gba_screen_height, [&](int y_min, int y_max) {
+    ApplyColorCorrection(buffer, y_min, y_max);
+
+    if(video.lcd_ghosting && !xbrz) {
+      BlendWithHistory(frame.data(), history.data(), y_min * gba_screen_width, y_max * gba_screen_width);
+    }
+  });
+
+  // Output pass
+  switch(video.filter) {
+    // xBRZ freescale upsampling filter (two passes)
+    case Video::Filter::xBRZ: {
+      ParallelFor(gba_screen_height, [&](int y_min, int y_max) {
+        ApplyXBRZAnalysis(y_min, y_max);
+      });
+
+      ParallelFor(output_height, [&](int y_min, int y_max) {
+        ApplyXBRZ(y_min, y_max);
+
+        if(video.lcd_ghosting) {
+          BlendWithHistory(output.data(), history.data(), y_min * output_width, y_max * output_width);
+        }
+      });
+      break;
+    }
+    // Linear and sharp bilinear.
+    case Video::Filter::Linear:
+    case Video::Filter::Sharp: {
+      ParallelFor(output_height, [&](int y_min, int y_max) {
+        ApplyBilinear(y_min, y_max);
+      });
+      break;
+    }
+    // Nearest and Lcd1x filter.
+    case Video::Filter::Nearest:
+    case Video::Filter::Lcd1x: {
+      ParallelFor(output_height, [&](int y_min, int y_max) {
+        ApplyNearest(y_min, y_max);
+      });
+      break;
+    }
+  }
+
+  if(frame_callback) {
+    frame_callback(output.data(), output_width, output_height);
+  }
+}
+
+void SoftwareVideoDevice::ApplyColorCorrection(u32 const* buffer, int y_min, int y_max) {
+  const int begin = y_min * gba_screen_width;
+  const int end = y_max * gba_screen_width;
+
+  for(int i = begin; i < end; i++) {
+    const u32 color = buffer[i];
+
+    frame[i] = color_lut[((color >> 9) & 0x7C00) | ((color >> 6) & 0x03E0) | ((color >> 3) & 0x001F)];
+  }
+
+  if(video.filter == Video::Filter::xBRZ) {
+    for(int i = begin; i < end; i++) {
+      const u32 color = frame[i];
+
+      xbrz_colors[i] = {
+        ((color >> 16) & 0xFF) / 255.0f,
+        ((color >>  8) & 0xFF) / 255.0f,
+        ( color        & 0xFF) / 255.0f
+      };
+    }
+  }
+}
+
+void SoftwareVideoDevice::ApplyNearest(int y_min, int y_max) {
+  const bool lcd1x = video.filter == Video::Filter::Lcd1x;
+
+  for(int y = y_min; y < y_max; y++) {
+    u32* dst = &output[y * output_width];
+    u32 const* src = &frame[taps_y[y].index[0] * gba_screen_width];
+
+    if(lcd1x) {
+      const int shade_row = shade_y[y];
+
+      for(int x = 0; x < output_width; x++) {
+        dst[x] = Shade(src[taps_x[x].index[0]], (shade_x[x] * shade_row + 128) >> 8);
+      }
+    } else if(y != y_min && taps_y[y].index[0] == taps_y[y - 1].index[0]) {
+      std::copy_n(dst - output_width, output_width, dst);
+    } else {
+      for(int x = 0; x < output_width; x++) {
+        dst[x] = src[taps_x[x].index[0]];
+      }
+    }
+  }
+}
+
+void SoftwareVideoDevice::ApplyBilinear(int y_min, int y_max) {
+  u32 row[gba_screen_width];
+
+  for(int y = y_min; y < y_max; y++) {
+    auto const& tap_y = taps_y[y];
+    u32* dst = &output[y * output_width];
+    u32 const* src0 = &frame[tap_y.index[0] * gba_screen_width];
+    u32 const* src1 = &frame[tap_y.index[1] * gba_screen_width];
+
+    // Interpolate vertically first, so that only one row needs to be interpolated horizontally.
+    for(int x = 0; x < gba_screen_width; x++) {
+      row[x] = Lerp(src0[x], src1[x], tap_y.weight);
+    }
+
+    for(int x = 0; x < output_width; x++) {
+      auto const& tap_x = taps_x[x];
+
+      dst[x] = 0xFF000000 | Lerp(row[tap_x.index[0]], row[tap_x.index[1]], tap_x.weight);
+    }
+  }
+}
+
+auto SoftwareVideoDevice::DistYCbCr(Color const& a, Color const& b) -> float {
+  constexpr float w_r = 0.2627f;
+  constexpr float w_g = 0.6780f;
+  constexpr float w_b = 0.0593f;
+  constexpr float scale_b = 0.5f / (1.0f - w_b);
+  constexpr float scale_r = 0.5f / (1.0f - w_r);
+
+  const float diff_r = a.r - b.r;
+  const float diff_g = a.g - b.g;
+  const float diff_b = a.b - b.b;
+  const float y  = diff_r * w_r + diff_g * w_g + diff_b * w_b;
+  const float cb = scale_b * (diff_b - y);
+  const float cr = scale_r * (diff_r - y);
+
+  return std::sqrt(y * y + cb * cb + cr * cr);
+}
+
+/**
+ * First pass of the xBRZ filter, which is a port of the xbrz0 fragment shader:
+ * for every input pixel, detect how each of its four corners should be blended.
+ * The result is packed into one byte per corner (x: top-left, y: top-right, z: bottom-right, w: bottom-left).
+ */
+void SoftwareVideoDevice::ApplyXBRZAnalysis(int y_min, int y_max) {
+  for(int y = y_min; y < y_max; y++) {
+    for(int x = 0; x < gba_screen_width; x++) {
+      const auto P = [&](int dx, int dy) {
+        return std::clamp(y + dy, 0, gba_screen_height - 1) * gba_screen_width +
+               std::clamp(x + dx, 0, gba_screen_width  - 1);
+      };
+
+      const auto eq = [&](int a, int b) {
+        return frame[a] == frame[b];
+      };
+
+      const auto dist = [&](int a, int b) {
+        return DistYCbCr(xbrz_colors[a], xbrz_colors[b]);
+      };
+
+      const auto is_pix_equal = [&](int a, int b) {
+        return dist(a, b) < kEqualColorTolerance;
+      };
+
+      // Input Pixel Mapping: -|x|x|x|-
+      //                      x|A|B|C|x
+      //                      x|D|E|F|x
+      //                      x|G|H|I|x
+      //                      -|x|x|x|-
+      const int A = P(-1, -1);
+      const int B = P( 0, -1);
+      const int C = P( 1, -1);
+      const int D = P(-1,  0);
+      const int E = P( 0,  0);
+      const int F = P( 1,  0);
+      const int G = P(-1,  1);
+      const int H = P( 0,  1);
+      const int I = P( 1,  1);
+
+      int blend_x = kBlendNone;
+      int blend_y = kBlendNone;
+      int blend_z = kBlendNone;
+      int blend_w = kBlendNone;
+
+      if(!((eq(E, F) && eq(H, I)) || (eq(E, H) && eq(F, I)))) {
+        const float dist_H_F = dist(G, E) + dist(E, C) + dist(P(0, 2), I) + dist(I, P(2, 0)) + 4.0f * dist(H, F);
+        const float dist_E_I = dist(D, H) + dist(H, P(1, 2)) + dist(B, F) + dist(F, P(2, 1)) + 4.0f * dist(E, I);
+        const bool dominant_gradient = kDominantDirectionThreshold * dist_H_F < dist_E_I;
+
+        if(dist_H_F < dist_E_I && !eq(E, F) && !eq(E, H)) {
+          blend_z = dominant_gradient ? kBlendDominant : kBlendNormal;
+        }
+      }
+
+      if(!((eq(D, E) && eq(G, H)) || (eq(D, G) && eq(E, H)))) {
+        const float dist_G_E = dist(P(-2, 1), D) + dist(D, B) + dist(P(-1, 2), H) + dist(H, F) + 4.0f * dist(G, E);
+        const float dist_D_H = dist(P(-2, 0), G) + dist(G, P(0, 2)) + dist(A, E) + dist(E, I) + 4.0f * dist(D, H);
+        const bool dominant_gradient = kDominantDirectionThreshold * dist_D_H < dist_G_E;
+
+        if(dist_G_E > dist_D_H && !eq(E, D) && !eq(E, H)) {
+          blend_w = dominant_gradient ? kBlendDominant : kBlendNormal;
+        }
+      }
+
+      if(!((eq(B, C) && eq(E, F)) || (eq(B, E) && eq(C, F)))) {
+        const float dist_E_C = dist(D, B) + dist(B, P(1, -2)) + dist(H, F) + dist(F, P(2, -1)) + 4.0f * dist(E, C);
+        const float dist_B_F = dist(A, E) + dist(E, I) + dist(P(0, -2), C) + dist(C, P(2, 0)) + 4.0f * dist(B, F);
+        const bool dominant_gradient = kDominantDirectionThreshold * dist_B_F < dist_E_C;
+
+        if(dist_E_C > dist_B_F && !eq(E, B) && !eq(E, F)) {
+          blend_y = dominant_gradient ? kBlendDominant : kBlendNormal;
+        }
+      }
+
+      if(!((eq(A, B) && eq(D, E)) || (eq(A, D) && eq(B, E)))) {
+        const float dist_D_B = dist(P(-2, 0), A) + dist(A, P(0, -2)) + dist(G, E) + dist(E, C) + 4.0f * dist(D, B);
+        const float dist_A_E = dist(P(-2, -1), D) + dist(D, H) + dist(P(-1, -2), B) + dist(B, F) + 4.0f * dist(A, E);
+        const bool dominant_gradient = kDominantDirectionThreshold * dist_D_B < dist_A_E;
+
+        if(dist_D_B < dist_A_E && !eq(E, D) && !eq(E, B)) {
+          blend_x = dominant_gradient ? kBlendDominant : kBlendNormal;
+        }
+      }
+
+      u32 info_x = blend_x;
+      u32 info_y = blend_y;
+      u32 info_z = blend_z;
+      u32 info_w = blend_w;
+
+      if(blend_z == kBlendDominant || (blend_z == kBlendNormal &&
+         !((blend_y != kBlendNone && !is_pix_equal(E, G)) || (blend_w != kBlendNone && !is_pix_equal(E, C)) ||
+           (is_pix_equal(G, H) && is_pix_equal(H, I) && is_pix_equal(I, F) && is_pix_equal(F, C) && !is_pix_equal(E, I))))) {
+        const float dist_F_G = dist(F, G);
+        const float dist_H_C = dist(H, C);
+
+        info_z += 4;
+        if(kSteepDirectionThreshold * dist_F_G <= dist_H_C && !eq(E, G) && !eq(D, G)) info_z += 16;
+        if(kSteepDirectionThreshold * dist_H_C <= dist_F_G && !eq(E, C) && !eq(B, C)) info_z += 64;
+      }
+
+      if(blend_w == kBlendDominant || (blend_w == kBlendNormal &&
+         !((blend_z != kBlendNone && !is_pix_equal(E, A)) || (blend_x != kBlendNone && !is_pix_equal(E, I)) ||
+           (is_pix_equal(A, D) && is_pix_equal(D, G) && is_pix_equal(G, H) && is_pix_equal(H, I) && !is_pix_equal(E, G))))) {
+        const float dist_H_A = dist(H, A);
+        const float dist_D_I = dist(D, I);
+
+        info_w += 4;
+        if(kSteepDirectionThreshold * dist_H_A <= dist_D_I && !eq(E, A) && !eq(B, A)) info_w += 16;
+        if(kSteepDirectionThreshold * dist_D_I <= dist_H_A && !eq(E, I) && !eq(F, I)) info_w += 64;
+      }
+
+      if(blend_y == kBlendDominant || (blend_y == kBlendNormal &&
+         !((blend_x != kBlendNone && !is_pix_equal(E, I)) || (blend_z != kBlendNone && !is_pix_equal(E, A)) ||
+           (is_pix_equal(I, F) && is_pix_equal(F, C) && is_pix_equal(C, B) && is_pix_equal(B, A) && !is_pix_equal(E, C))))) {
+        const float dist_B_I = dist(B, I);
+        const float dist_F_A = dist(F, A);
+
+        info_y += 4;
+        if(kSteepDirectionThreshold * dist_B_I <= dist_F_A && !eq(E, I) && !eq(H, I)) info_y += 16;
+        if(kSteepDirectionThreshold * dist_F_A <= dist_B_I && !eq(E, A) && !eq(D, A)) info_y += 64;
+      }
+
+      if(blend_x == kBlendDominant || (blend_x == kBlendNormal &&
+         !((blend_w != kBlendNone && !is_pix_equal(E, C)) || (blend_y != kBlendNone && !is_pix_equal(E, G)) ||
+           (is_pix_equal(C, B) && is_pix_equal(B, A) && is_pix_equal(A, D) && is_pix_equal(D, G) && !is_pix_equal(E, A))))) {
+        const float dist_D_C = dist(D, C);
+        const float dist_B_G = dist(B, G);
+
+        info_x += 4;
+        if(kSteepDirectionThreshold * dist_D_C <= dist_B_G && !eq(E, C) && !eq(F, C)) info_x += 16;
+        if(kSteepDirectionThreshold * dist_B_G <= dist_D_C && !eq(E, G) && !eq(H, G)) info_x += 64;
+      }
+
+      xbrz_info[E] = info_x | info_y << 8 | info_z << 16 | info_w << 24;
+    }
+  }
+}
+
+/**
+ * Second pass of the xBRZ filter, which is a port of the xbrz1 fragment shader:
+ * blend each output pixel with the neighbouring input pixels, according to the corner information from the first pass.
+ */
+void SoftwareVideoDevice::ApplyXBRZ(int y_min, int y_max) {
+  const float scale_x = (float)output_width / gba_screen_width;
+  const float scale_y = (float)output_height / gba_screen_height;
+
+  const auto to_u8 = [](float value) {
+    return (u32)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+  };
+
+  for(int y = y_min; y < y_max; y++) {
+    auto const& tap_y = taps_y[y];
+    u32* dst = &output[y * output_width];
+
+    for(int x = 0; x < output_width; x++) {
+      auto const& tap_x = taps_x[x];
+
+      const int E = tap_y.index[0] * gba_screen_width + tap_x.index[0];
+      const u32 info = xbrz_info[E];
+
+      // Most pixels are not on an edge and are left as they are.
+      if(info == 0) {
+        dst[x] = frame[E];
+        continue;
+      }
+
+      // Input Pixel Mapping: -|B|-
+      //                      D|E|F
+      //                      -|H|-
+      const int B = E - (tap_y.index[0] > 0 ? gba_screen_width : 0);
+      const int D = E - (tap_x.index[0] > 0 ? 1 : 0);
+      const int F = E + (tap_x.index[0] < gba_screen_width  - 1 ? 1 : 0);
+      const int H = E + (tap_y.index[0] < gba_screen_height - 1 ? gba_screen_width : 0);
+
+      const float pos_x = tap_x.offset;
+      const float pos_y = tap_y.offset;
+
+      const auto dist = [&](int a, int b) {
+        return DistYCbCr(xbrz_colors[a], xbrz_colors[b]);
+      };
+
+      const auto left_ratio = [&](float origin_x, float origin_y, float direction_x, float direction_y) {
+        const float p0_x = pos_x - origin_x;
+        const float p0_y = pos_y - origin_y;
+        const float t = (p0_x * direction_x + p0_y * direction_y) / (direction_x * direction_x + direction_y * direction_y);
+        const float dist_x = (p0_x - direction_x * t) * scale_x;
+        const float dist_y = (p0_y - direction_y * t) * scale_y;
+        const float orth = p0_y * direction_x - p0_x * direction_y;
+        const float side = orth > 0.0f ? 1.0f : (orth < 0.0f ? -1.0f : 0.0f);
+        const float v = side * std::sqrt(dist_x * dist_x + dist_y * dist_y);
+
+        // smoothstep(-sqrt(2)/2, sqrt(2)/2, v)
+        const float s = std::clamp((v + kSqrt2 * 0.5f) / kSqrt2, 0.0f, 1.0f);
+        return s * s * (3.0f - 2.0f * s);
+      };
+
+      Color res = xbrz_colors[E];
+
+      const auto blend = [&](int pixel, float ratio) {
+        auto const& color = xbrz_colors[pixel];
+
+        res.r += (color.r - res.r) * ratio;
+        res.g += (color.g - res.g) * ratio;
+        res.b += (color.b - res.b) * ratio;
+      };
+
+      const int info_x = info & 0xFF;
+      const int info_y = (info >>  8) & 0xFF;
+      const int info_z = (info >> 16) & 0xFF;
+      const int info_w = info >> 24;
+
+      // Pixel Tap Mapping: -|-|-
+      //                    -|E|F
+      //                    -|H|-
+      if((info_z & 3) != kBlendNone) {
+        const int have_shallow_line = (info_z >> 4) & 3;
+        const int have_steep_line = (info_z >> 6) & 3;
+        float origin_x = 0.0f;
+        float origin_y = 1.0f / kSqrt2;
+        float direction_x = 1.0f;
+        float direction_y = -1.0f;
+
+        if(((info_z >> 2) & 3) != 0) {
+          origin_y = have_shallow_line ? 0.25f : 0.5f;
+          direction_x += have_shallow_line;
+          direction_y -= have_steep_line;
+        }
+
+        blend(dist(E, H) >= dist(E, F) ? F : H, left_ratio(origin_x, origin_y, direction_x, direction_y));
+      }
+
+      // Pixel Tap Mapping: -|-|-
+      //                    D|E|-
+      //                    -|H|-
+      if((info_w & 3) != kBlendNone) {
+        const int have_shallow_line = (info_w >> 4) & 3;
+        const int have_steep_line = (info_w >> 6) & 3;
+        float origin_x = -1.0f / kSqrt2;
+        float origin_y = 0.0f;
+        float direction_x = 1.0f;
+        float direction_y = 1.0f;
+
+        if(((info_w >> 2) & 3) != 0) {
+          origin_x = have_shallow_line ? -0.25f : -0.5f;
+          direction_y += have_shallow_line;
+          direction_x += have_steep_line;
+        }
+
+        blend(dist(E, H) >= dist(E, D) ? D : H, left_ratio(origin_x, origin_y, direction_x, direction_y));
+      }
+
+      // Pixel Tap Mapping: -|B|-
+      //                    -|E|F
+      //                    -|-|-
+      if((info_y & 3) != kBlendNone) {
+        const int have_shallow_line = (info_y >> 4) & 3;
+        const int have_steep_line = (info_y >> 6) & 3;
+        float origin_x = 1.0f / kSqrt2;
+        float origin_y = 0.0f;
+        float direction_x = -1.0f;
+        float direction_y = -1.0f;
+
+        if(((info_y >> 2) & 3) != 0) {
+          origin_x = have_shallow_line ? 0.25f : 0.5f;
+          direction_y -= have_shallow_line;
+          direction_x -= have_steep_line;
+        }
+
+        blend(dist(E, F) >= dist(E, B) ? B : F, left_ratio(origin_x, origin_y, direction_x, direction_y));
+      }
+
+      // Pixel Tap Mapping: -|B|-
+      //                    D|E|-
+      //                    -|-|-
+      if((info_x & 3) != kBlendNone) {
+        const int have_shallow_line = (info_x >> 4) & 3;
+        const int have_steep_line = (info_x >> 6) & 3;
+        float origin_x = 0.0f;
+        float origin_y = -1.0f / kSqrt2;
+        float direction_x = -1.0f;
+        float direction_y = 1.0f;
+
+        if(((info_x >> 2) & 3) != 0) {
+          origin_y = have_shallow_line ? -0.25f : -0.5f;
+          direction_x -= have_shallow_line;
+          direction_y += have_steep_line;
+        }
+
+        blend(dist(E, D) >= dist(E, B) ? B : D, left_ratio(origin_x, origin_y, direction_x, direction_y));
+      }
+
+      dst[x] = 0xFF000000 | to_u8(res.r) << 16 | to_u8(res.g) << 8 | to_u8(res.b);
+    }
+  }
+}
+
+/**
+ * Split the range [0, count) into one band per thread and run the task on all bands in parallel.
+ * Returns once all bands have been processed.
+ */
+void SoftwareVideoDevice::ParallelFor(int count, std::function<void(int, int)> const& task) {
+  const int bands = band_count;
+
+  if(bands == 1) {
+    task(0, count);
+    return;
+  }
+
+  {
+    std::lock_guard lock{job_mutex};
+    job_task = &task;
+    job_count = count;
+    job_pending = bands - 1;
+    job_generation++;
+  }
+  job_cv.notify_all();
+
+  task(0, count / bands);
+
+  std::unique_lock lock{job_mutex};
+  job_done_cv.wait(lock, [this]() { return job_pending == 0; });
+  job_task = nullptr;
+}
+
+void SoftwareVideoDevice::WorkerLoop(int index) {
+  const int bands = band_count;
+
+  u64 generation = 0;
+
+  std::unique_lock lock{job_mutex};
+
+  while(true) {
+    job_cv.wait(lock, [&]() { return workers_quit || job_generation != generation; });
+
+    if(workers_quit) {
+      return;
+    }
+
+    generation = job_generation;
+
+    auto const& task = *job_task;
+    const int count = job_count;
+
+    lock.unlock();
+    task(count * index / bands, count * (index + 1) / bands);
+    lock.lock();
+
+    if(--job_pending == 0) {
+      job_done_cv.notify_one();
+    }
+  }
+}
+
+} // namespace nba
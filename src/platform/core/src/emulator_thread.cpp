@@ -38,7 +38,11 @@ void EmulatorThread::SetFastForward(bool enabled) {
   frame_limiter.SetFastForward(enabled);
 }
 
-void EmulatorThread::SetFrameRateCallback(std::function<void(float)> callback) {
+void EmulatorThread::SetFrameLimiterMode(FrameLimiter::Mode mode) {
+  frame_limiter_mode = mode;
+}
+
+void EmulatorThread::SetFrameRateCallback(std::function<void(float, FrameLimiter::Statistics const&)> callback) {
   frame_rate_cb = callback;
 }
 
@@ -58,18 +62,21 @@ void EmulatorThread::Start(std::unique_ptr<CoreBase> core) {
     while(running.load()) {
       ProcessMessages();
 
+      // There is no deadline worth yielding the CPU for while the emulator is paused.
+      frame_limiter.SetMode(paused ? FrameLimiter::Mode::Sleep : frame_limiter_mode.load());
+
       frame_limiter.Run([this]() {
         if(!paused) {
           // @todo: decide what to do with the per_frame_cb().
           per_frame_cb();
           this->core->Run(k_cycles_per_subframe);
         }
-      }, [this](float fps) {
+      }, [this](float fps, FrameLimiter::Statistics const& stats) {
         float real_fps = fps / k_number_of_input_subframes;
         if(paused) {
           real_fps = 0;
         }
-        frame_rate_cb(real_fps);
+        frame_rate_cb(real_fps, stats);
       });
     }
 
@@ -82,6 +89,9 @@ std::unique_ptr<CoreBase> EmulatorThread::Stop() {
   if(IsRunning()) {
     running = false;
     thread.join();
+
+    // Handle messages that were pushed while the thread was exiting.
+    ProcessMessages();
   }
 
   return std::move(core);
@@ -98,10 +108,37 @@ void EmulatorThread::SetKeyStatus(Key key, bool pressed) {
   });
 }
 
+void EmulatorThread::SetFrameSkip(int frameskip) {
+  PushMessage({
+    .type = MessageType::SetFrameSkip,
+    .set_frame_skip = {.frameskip = frameskip}
+  });
+}
+
+void EmulatorThread::LoadState(std::unique_ptr<SaveState> state) {
+  PushMessage({
+    .type = MessageType::LoadState,
+    .load_state = {.state = state.release()}
+  });
+}
+
+auto EmulatorThread::CopyState() -> std::future<std::unique_ptr<SaveState>> {
+  auto promise = new std::promise<std::unique_ptr<SaveState>>{};
+  auto future = promise->get_future();
+
+  PushMessage({
+    .type = MessageType::CopyState,
+    .copy_state = {.promise = promise}
+  });
+
+  return future;
+}
+
 void EmulatorThread::PushMessage(const Message& message) {
   // @todo: think of the best way to transparently handle messages
   // sent while the emulator thread isn't running.
   if(!IsRunning()) {
+    DiscardMessage(message);
     return;
   }
 
@@ -111,19 +148,19 @@ void EmulatorThread::PushMessage(const Message& message) {
     // Process them right away instead to reduce latency.
     ProcessMessage(message);
   } else {
-    std::lock_guard lock_guard{msg_queue_mutex};
-    msg_queue.push(message); // @todo: maybe use emplace.
+    // The queue only fills up if the emulator thread is stalled, so waiting for it is fine.
+    while(!msg_queue.TryPush(message)) {
+      std::this_thread::yield();
+    }
   }
 }
 
 void EmulatorThread::ProcessMessages() {
-  // potential optimization: use a separate std::atomic_int to track the number of messages in the queue
-  // use atomic_int to do early bail out without acquiring the mutex.
-  std::lock_guard lock_guard{msg_queue_mutex};
+  Message message;
 
-  while(!msg_queue.empty()) {
-    ProcessMessage(msg_queue.front());
-    msg_queue.pop();
+  // If the queue is empty, this is a single atomic load.
+  while(msg_queue.TryPop(message)) {
+    ProcessMessage(message);
   }
 }
 
@@ -137,8 +174,41 @@ void EmulatorThread::ProcessMessage(const Message& message) {
       core->SetKeyStatus(message.set_key_status.key, message.set_key_status.pressed);
       break;
     }
+    case MessageType::SetFrameSkip: {
+      core->SetFrameSkip(message.set_frame_skip.frameskip);
+      break;
+    }
+    case MessageType::LoadState: {
+      std::unique_ptr<SaveState> state{message.load_state.state};
+
+      core->LoadState(*state);
+      break;
+    }
+    case MessageType::CopyState: {
+      std::unique_ptr<std::promise<std::unique_ptr<SaveState>>> promise{message.copy_state.promise};
+
+      auto state = std::make_unique<SaveState>();
+      core->CopyState(*state);
+      promise->set_value(std::move(state));
+      break;
+    }
     default: Assert(false, "unhandled message type: {}", (int)message.type);
   }
 }
 
+void EmulatorThread::DiscardMessage(const Message& message) {
+  switch(message.type) {
+    case MessageType::LoadState: {
+      delete message.load_state.state;
+      break;
+    }
+    case MessageType::CopyState: {
+      message.copy_state.promise->set_value(nullptr);
+      delete message.copy_state.promise;
+      break;
+    }
+    default: break;
+  }
+}
+
 } // namespace nba
@@ -5,6 +5,7 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
 #include <platform/frame_limiter.hpp>
 
 namespace nba {
@@ -20,6 +21,9 @@ void FrameLimiter::Reset(float fps) {
   fast_forward = false;
   timestamp_target = std::chrono::steady_clock::now();
   timestamp_fps_update = std::chrono::steady_clock::now();
+  timestamp_frame_end = std::chrono::steady_clock::now();
+  frame_times.clear();
+  lateness.clear();
 }
 
 auto FrameLimiter::GetFastForward() const -> bool {
@@ -35,9 +39,17 @@ void FrameLimiter::SetFastForward(bool value) {
   }
 }
 
+auto FrameLimiter::GetMode() const -> Mode {
+  return mode;
+}
+
+void FrameLimiter::SetMode(Mode mode) {
+  this->mode = mode;
+}
+
 void FrameLimiter::Run(
   std::function<void(void)> frame_advance,
-  std::function<void(float)> update_fps
+  std::function<void(float, Statistics const&)> update_fps
 ) {
   if(!fast_forward) {
     timestamp_target += std::chrono::microseconds(frame_duration);
@@ -45,20 +57,77 @@ void FrameLimiter::Run(
 
   frame_advance();
   frame_count++;
-    
-  auto now = std::chrono::steady_clock::now(); 
+
+  auto now = std::chrono::steady_clock::now();
   auto fps_update_delta = std::chrono::duration_cast<std::chrono::milliseconds>(
     now - timestamp_fps_update).count();
 
   if(fps_update_delta >= kMillisecondsPerSecond) {
-    update_fps(frame_count * float(kMillisecondsPerSecond) / fps_update_delta);
+    update_fps(frame_count * float(kMillisecondsPerSecond) / fps_update_delta, GetStatistics());
     frame_count = 0;
     timestamp_fps_update = std::chrono::steady_clock::now();
   }
 
   if(!fast_forward) {
+    Wait();
+  }
+
+  now = std::chrono::steady_clock::now();
+
+  frame_times.push_back((int)std::chrono::duration_cast<std::chrono::microseconds>(
+    now - timestamp_frame_end).count());
+  timestamp_frame_end = now;
+}
+
+void FrameLimiter::Wait() {
+  if(mode == Mode::Hybrid) {
+    std::this_thread::sleep_until(timestamp_target - kSpinThreshold);
+
+    while(std::chrono::steady_clock::now() < timestamp_target) {
+      std::this_thread::yield();
+    }
+  } else {
     std::this_thread::sleep_until(timestamp_target);
   }
+
+  const auto late = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - timestamp_target).count();
+
+  lateness.push_back((int)late);
+
+  /**
+   * The deadlines are absolute, so that small amounts of lateness do not accumulate into drift:
+   * the next frame simply gets less time. If we fell behind by more than a frame however
+   * (for example because the host was busy or the emulator thread was paused by the debugger),
+   * catching up would run a burst of frames at an unlimited rate. Start over from now instead.
+   */
+  if(late > frame_duration) {
+    timestamp_target = std::chrono::steady_clock::now();
+  }
+}
+
+auto FrameLimiter::GetStatistics() -> Statistics {
+  const auto percentile = [](std::vector<int>& samples, int percent) -> float {
+    if(samples.empty()) {
+      return 0;
+    }
+
+    const auto nth = samples.begin() + (samples.size() - 1) * percent / 100;
+
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth / float(kMillisecondsPerSecond);
+  };
+
+  Statistics stats;
+
+  stats.frame_time_p50 = percentile(frame_times, 50);
+  stats.frame_time_p99 = percentile(frame_times, 99);
+  stats.lateness_p50 = percentile(lateness, 50);
+  stats.lateness_p99 = percentile(lateness, 99);
+
+  frame_times.clear();
+  lateness.clear();
+  return stats;
 }
 
 } // namespace nba
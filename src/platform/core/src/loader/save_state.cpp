@@ -14,6 +14,19 @@ namespace nba {
 auto SaveStateLoader::Load(
   std::unique_ptr<CoreBase>& core,
   fs::path const& path
+) -> Result {
+  auto save_state = std::make_unique<SaveState>();
+  auto result = Load(path, *save_state);
+
+  if(result == Result::Success) {
+    core->LoadState(*save_state);
+  }
+  return result;
+}
+
+auto SaveStateLoader::Load(
+  fs::path const& path,
+  SaveState& save_state
 ) -> Result {
   if(!fs::exists(path)) {
     return Result::CannotFindFile;
@@ -29,8 +42,6 @@ auto SaveStateLoader::Load(
     return Result::BadImage;
   }
 
-  SaveState save_state;
-
   std::ifstream file_stream{path.c_str(), std::ios::binary};
 
   if(!file_stream.good()) {
@@ -39,14 +50,7 @@ auto SaveStateLoader::Load(
 
   file_stream.read((char*)&save_state, sizeof(SaveState));
 
-  auto validate_result = Validate(save_state);
-
-  if(validate_result != Result::Success) {
-    return validate_result;
-  }
-
-  core->LoadState(save_state);
-  return Result::Success;
+  return Validate(save_state);
 }
 
 auto SaveStateLoader::Validate(SaveState const& save_state) -> Result {
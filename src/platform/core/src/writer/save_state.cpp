@@ -13,6 +13,16 @@ namespace nba {
 auto SaveStateWriter::Write(
   std::unique_ptr<CoreBase>& core,
   fs::path const& path
+) -> Result {
+  auto save_state = std::make_unique<SaveState>();
+  core->CopyState(*save_state);
+
+  return Write(*save_state, path);
+}
+
+auto SaveStateWriter::Write(
+  SaveState const& save_state,
+  fs::path const& path
 ) -> Result {
   std::ofstream file_stream{path.c_str(), std::ios::binary};
 
@@ -20,9 +30,6 @@ auto SaveStateWriter::Write(
     return Result::CannotOpenFile;
   }
 
-  SaveState save_state;
-  core->CopyState(save_state);
-
   file_stream.write((const char*)&save_state, sizeof(SaveState));
   
   if(!file_stream.good()) {
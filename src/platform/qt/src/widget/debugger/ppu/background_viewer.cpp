@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <fmt/format.h>
+#include <nba/common/affine_sampler.hpp>
 #include <nba/common/punning.hpp>
 #include <optional>
 #include <QEvent>
@@ -20,7 +21,7 @@
 #include "widget/debugger/utility.hpp"
 #include "background_viewer.hpp"
 
-BackgroundViewer::BackgroundViewer(nba::CoreBase* core, QWidget* parent) : QWidget(parent), m_core(core) {
+BackgroundViewer::BackgroundViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QWidget(parent), m_snapshots(snapshots) {
   QHBoxLayout* hbox = new QHBoxLayout{};
 
   setLayout(hbox);
@@ -29,9 +30,6 @@ BackgroundViewer::BackgroundViewer(nba::CoreBase* core, QWidget* parent) : QWidg
   hbox->addWidget(CreateCanvasScrollArea());
   hbox->setStretch(1, 1);
 
-  m_pram = (u16*)core->GetPRAM();
-  m_vram = core->GetVRAM();
-
   m_image_rgb565 = new u16[1024 * 1024];
 }
 
@@ -138,7 +136,11 @@ QLayout* BackgroundViewer::CreateInfoPanel() {
 
   m_check_display_screen_viewport = new QCheckBox{tr("Display screen viewport")};
   m_check_display_screen_viewport->setChecked(true);
-  
+
+  connect(m_check_display_screen_viewport, &QCheckBox::toggled, [this]() {
+    m_canvas->update();
+  });
+
   vbox->addWidget(CreateBackgroundInfoGroupBox());
   vbox->addWidget(CreateTileInfoGroupBox());
   vbox->addWidget(m_check_display_screen_viewport);
@@ -157,6 +159,7 @@ QWidget* BackgroundViewer::CreateCanvasScrollArea() {
 
 void BackgroundViewer::SetBackgroundID(int id) {
   m_bg_id = id;
+  m_image_valid = false;
 }
 
 void BackgroundViewer::Update() {
@@ -164,7 +167,9 @@ void BackgroundViewer::Update() {
     return;
   }
 
-  m_bg_mode = m_core->PeekHalfIO(0x04000000) & 7;
+  const auto& snapshot = m_snapshots->Acquire();
+
+  m_bg_mode = snapshot.dispcnt & 7;
 
   switch(m_bg_mode) {
     case 0: setEnabled(true); break;
@@ -180,7 +185,7 @@ void BackgroundViewer::Update() {
     return;
   }
 
-  const u16 bgcnt = m_core->PeekHalfIO(0x04000008 + (m_bg_id << 1));
+  const u16 bgcnt = snapshot.bgcnt[m_bg_id];
   const int priority = bgcnt & 3;
   const u32 tile_base = ((bgcnt >> 2) & 3) << 14;
   const u32 map_base = ((bgcnt >> 8) & 31) << 11;
@@ -192,12 +197,15 @@ void BackgroundViewer::Update() {
 
   const bool text_mode = m_bg_mode == 0 || (m_bg_mode == 1 && m_bg_id < 2);
 
+  bool scroll_changed = false;
+
   if(text_mode) {
     width  = 256 << ((bgcnt >> 14) & 1);
     height = 256 <<  (bgcnt >> 15);
     use_8bpp = bgcnt & (1 << 7);
-    m_bghofs = m_core->GetBGHOFS(m_bg_id);
-    m_bgvofs = m_core->GetBGVOFS(m_bg_id);
+    scroll_changed = m_bghofs != snapshot.bghofs[m_bg_id] || m_bgvofs != snapshot.bgvofs[m_bg_id];
+    m_bghofs = snapshot.bghofs[m_bg_id];
+    m_bgvofs = snapshot.bgvofs[m_bg_id];
   } else if(m_bg_mode <= 2) {
     width  = 128 << (bgcnt >> 14);
     height = width;
@@ -223,27 +231,47 @@ void BackgroundViewer::Update() {
     m_label_bg_scroll->setText("-");
   }
 
+  /**
+   * Only the parts of the background whose map entries or tiles changed since the image was last drawn
+   * need to be decoded again. If the palette or any of the registers changed, the whole background needs to be redrawn.
+   */
+  const bool redraw_all = !m_image_valid ||
+    m_drawn_dispcnt != snapshot.dispcnt ||
+    m_drawn_bgcnt != bgcnt ||
+    snapshot.PRAMChangedSince(m_drawn_sequence, 0, 256 * sizeof(u16));
+
+  bool redrawn = false;
+
   switch(m_bg_mode) {
-    case 0: DrawBackgroundMode0(); break;
+    case 0: redrawn = DrawBackgroundMode0(snapshot, redraw_all); break;
     case 1: {
       if(m_bg_id < 2) {
-        DrawBackgroundMode0();
+        redrawn = DrawBackgroundMode0(snapshot, redraw_all);
       } else {
-        DrawBackgroundMode2();
+        redrawn = DrawBackgroundMode2(snapshot, redraw_all);
       }
       break;
     }
-    case 2: DrawBackgroundMode2(); break;
-    case 3: DrawBackgroundMode3(); break;
-    case 4: DrawBackgroundMode4(); break;
-    case 5: DrawBackgroundMode5(); break;
+    case 2: redrawn = DrawBackgroundMode2(snapshot, redraw_all); break;
+    case 3: redrawn = DrawBackgroundMode3(snapshot, redraw_all); break;
+    case 4: redrawn = DrawBackgroundMode4(snapshot, redraw_all); break;
+    case 5: redrawn = DrawBackgroundMode5(snapshot, redraw_all); break;
     default: {
       break;
     }
   }
 
-  m_canvas->setFixedSize(width, height);
-  m_canvas->update();
+  m_image_valid = true;
+  m_drawn_sequence = snapshot.sequence;
+  m_drawn_dispcnt = snapshot.dispcnt;
+  m_drawn_bgcnt = bgcnt;
+
+  const QSize size{width, height};
+
+  if(redrawn || scroll_changed || m_canvas->size() != size) {
+    m_canvas->setFixedSize(size);
+    m_canvas->update();
+  }
 }
 
 bool BackgroundViewer::eventFilter(QObject* object, QEvent* event) {
@@ -274,8 +302,11 @@ bool BackgroundViewer::eventFilter(QObject* object, QEvent* event) {
   return false;
 }
 
-void BackgroundViewer::DrawBackgroundMode0() {
-  const u16 bgcnt = m_core->PeekHalfIO(0x04000008 + (m_bg_id << 1));
+bool BackgroundViewer::DrawBackgroundMode0(nba::PPUSnapshot const& snapshot, bool redraw_all) {
+  const u16* pram = (u16 const*)snapshot.pram;
+  const u8*  vram = snapshot.vram;
+
+  const u16 bgcnt = snapshot.bgcnt[m_bg_id];
 
   const int screens_x = 1 + ((bgcnt >> 14) & 1);
   const int screens_y = 1 + (bgcnt >> 15);
@@ -285,66 +316,78 @@ void BackgroundViewer::DrawBackgroundMode0() {
   const u32 tile_base = ((bgcnt >> 2) & 3) << 14;
   const u32 map_base = ((bgcnt >> 8) & 31) << 11;
 
+  const u32 tile_size = use_8bpp ? 64 : 32;
+
   u32 map_address = map_base;
+  bool redrawn = false;
 
   for(int screen_y = 0; screen_y < screens_y; screen_y++) {
     for(int screen_x = 0; screen_x < screens_x; screen_x++) {
       for(int y = 0; y < 32; y++) {
         for(int x = 0; x < 32; x++) {
           const u32 map_entry_address = map_address + (y << 6 | x << 1);
-          const u16 map_entry = nba::read<u16>(m_vram, map_entry_address);
+          const u16 map_entry = nba::read<u16>(vram, map_entry_address);
 
           const int tile_number = map_entry & 0x3FF;
           const int flip_x = (map_entry & (1 << 10)) ? 7 : 0;
           const int flip_y = (map_entry & (1 << 11)) ? 7 : 0;
           const int palette = map_entry >> 12;
 
+          const u32 tile_address = tile_base + tile_number * tile_size;
+
+          if(!redraw_all &&
+             !snapshot.VRAMChangedSince(m_drawn_sequence, map_entry_address, sizeof(u16)) &&
+             !snapshot.VRAMChangedSince(m_drawn_sequence, tile_address, tile_size)) {
+            continue;
+          }
+
+          redrawn = true;
+
           auto& meta_data = m_tile_meta_data[screen_x << 5 | x][screen_y << 5 | y];
 
           meta_data.tile_number = tile_number;
           meta_data.map_entry_address = map_entry_address;
           meta_data.flip_v = flip_y > 0;
           meta_data.flip_h = flip_x > 0;
+          meta_data.tile_address = tile_address;
 
           if(use_8bpp) {
-            u32 tile_address = tile_base + (tile_number << 6);
+            u32 row_address = tile_address;
 
-            meta_data.tile_address = tile_address;
             meta_data.palette = 0;
 
             for(int tile_y = 0; tile_y < 8; tile_y++) {
-              u64 data = nba::read<u64>(m_vram, tile_address);
+              u64 data = nba::read<u64>(vram, row_address);
 
               const int image_y = screen_y << 8 | y << 3 | tile_y ^ flip_y;
 
               for(int tile_x = 0; tile_x < 8; tile_x++) {
                 const int image_x = screen_x << 8 | x << 3 | tile_x ^ flip_x;
 
-                m_image_rgb565[image_y * 1024 + image_x] = m_pram[(u8)data];
+                m_image_rgb565[image_y * 1024 + image_x] = pram[(u8)data];
                 data >>= 8;
               }
 
-              tile_address += sizeof(u64);
+              row_address += sizeof(u64);
             }
           } else {
-            u32 tile_address = tile_base + (tile_number << 5);
+            u32 row_address = tile_address;
 
-            meta_data.tile_address = tile_address;
             meta_data.palette = palette;
 
             for(int tile_y = 0; tile_y < 8; tile_y++) {
-              u32 data = nba::read<u32>(m_vram, tile_address);
+              u32 data = nba::read<u32>(vram, row_address);
 
               const int image_y = screen_y << 8 | y << 3 | tile_y ^ flip_y;
 
               for(int tile_x = 0; tile_x < 8; tile_x++) {
                 const int image_x = screen_x << 8 | x << 3 | tile_x ^ flip_x;
 
-                m_image_rgb565[image_y * 1024 + image_x] = m_pram[(palette << 4) | (data & 15)];
+                m_image_rgb565[image_y * 1024 + image_x] = pram[(palette << 4) | (data & 15)];
                 data >>= 4;
               }
 
-              tile_address += sizeof(u32);
+              row_address += sizeof(u32);
             }
           }
         }
@@ -353,24 +396,36 @@ void BackgroundViewer::DrawBackgroundMode0() {
       map_address += 2048;
     }
   }
+
+  return redrawn;
 }
 
-void BackgroundViewer::DrawBackgroundMode2() {
-  const u16 bgcnt = m_core->PeekHalfIO(0x04000008 + (m_bg_id << 1));
-  const int size = 128 << (bgcnt >> 14);
-  
+bool BackgroundViewer::DrawBackgroundMode2(nba::PPUSnapshot const& snapshot, bool redraw_all) {
+  const u16* pram = (u16 const*)snapshot.pram;
+  const u8*  vram = snapshot.vram;
+
+  const u16 bgcnt = snapshot.bgcnt[m_bg_id];
+  const int log_size = bgcnt >> 14;
+  const int size = 128 << log_size;
+
   const u32 tile_base = ((bgcnt >> 2) & 3) << 14;
   const u32 map_base = ((bgcnt >> 8) & 31) << 11;
 
+  if(!redraw_all &&
+     !snapshot.VRAMChangedSince(m_drawn_sequence, map_base, (size >> 3) * (size >> 3)) &&
+     !snapshot.VRAMChangedSince(m_drawn_sequence, tile_base, 256 * 64)) {
+    return false;
+  }
+
   u32 map_address = map_base;
 
   // @todo: rename x and y - also in the mode 0 code
 
   for(int y = 0; y < size; y += 8) {
     for(int x = 0; x < size; x += 8) {
-      const u8 tile_number = m_vram[map_address];
+      const u8 tile_number = vram[map_address];
 
-      u32 tile_address = tile_base + (tile_number << 6);
+      const u32 tile_address = tile_base + (tile_number << 6);
 
       auto& meta_data = m_tile_meta_data[x >> 3][y >> 3];
 
@@ -381,47 +436,79 @@ void BackgroundViewer::DrawBackgroundMode2() {
       meta_data.flip_h = false;
       meta_data.palette = 0;
 
-      for(int tile_y = 0; tile_y < 8; tile_y++) {
-        for(int tile_x = 0; tile_x < 8; tile_x++) {
-          m_image_rgb565[(y + tile_y) * 1024 + x + tile_x] = m_pram[m_vram[tile_address++]];
-        }
-      }
-
       map_address++;
     }
   }
+
+  // Sample the background line-by-line without any transformation applied.
+  u8 indices[1024];
+
+  for(int y = 0; y < size; y++) {
+    nba::SampleAffineBackground(vram, map_base, tile_base, log_size, true, 0, y << 8, 256, 0, size, indices);
+
+    for(int x = 0; x < size; x++) {
+      m_image_rgb565[y * 1024 + x] = pram[indices[x]];
+    }
+  }
+
+  return true;
 }
 
-void BackgroundViewer::DrawBackgroundMode3() {
+bool BackgroundViewer::DrawBackgroundMode3(nba::PPUSnapshot const& snapshot, bool redraw_all) {
+  const u8* vram = snapshot.vram;
+
   u32 address = 0;
 
+  if(!redraw_all && !snapshot.VRAMChangedSince(m_drawn_sequence, address, 240 * 160 * sizeof(u16))) {
+    return false;
+  }
+
   for(int y = 0; y < 160; y++) {
     for(int x = 0; x < 240; x++) {
-      m_image_rgb565[y * 1024 + x] = nba::read<u16>(m_vram, address);
+      m_image_rgb565[y * 1024 + x] = nba::read<u16>(vram, address);
       address += sizeof(u16);
     }
   }
+
+  return true;
 }
 
-void BackgroundViewer::DrawBackgroundMode4() {
-  u32 address = (m_core->PeekHalfIO(0x04000000) & 0x10U) * 0xA00U;
+bool BackgroundViewer::DrawBackgroundMode4(nba::PPUSnapshot const& snapshot, bool redraw_all) {
+  const u16* pram = (u16 const*)snapshot.pram;
+  const u8*  vram = snapshot.vram;
+
+  u32 address = (snapshot.dispcnt & 0x10U) * 0xA00U;
+
+  if(!redraw_all && !snapshot.VRAMChangedSince(m_drawn_sequence, address, 240 * 160)) {
+    return false;
+  }
 
   for(int y = 0; y < 160; y++) {
     for(int x = 0; x < 240; x++) {
-      m_image_rgb565[y * 1024 + x] = m_pram[nba::read<u8>(m_vram, address++)];
+      m_image_rgb565[y * 1024 + x] = pram[nba::read<u8>(vram, address++)];
     }
   }
+
+  return true;
 }
 
-void BackgroundViewer::DrawBackgroundMode5() {
-  u32 address = (m_core->PeekHalfIO(0x04000000) & 0x10U) * 0xA00U;
+bool BackgroundViewer::DrawBackgroundMode5(nba::PPUSnapshot const& snapshot, bool redraw_all) {
+  const u8* vram = snapshot.vram;
+
+  u32 address = (snapshot.dispcnt & 0x10U) * 0xA00U;
+
+  if(!redraw_all && !snapshot.VRAMChangedSince(m_drawn_sequence, address, 160 * 128 * sizeof(u16))) {
+    return false;
+  }
 
   for(int y = 0; y < 128; y++) {
     for(int x = 0; x < 160; x++) {
-      m_image_rgb565[y * 1024 + x] = nba::read<u16>(m_vram, address);
+      m_image_rgb565[y * 1024 + x] = nba::read<u16>(vram, address);
       address += sizeof(u16);
     }
   }
+
+  return true;
 }
 
 void BackgroundViewer::PresentBackground() {
@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QCheckBox>
 #include <QImage>
 #include <QLabel>
@@ -17,7 +17,7 @@
 
 class BackgroundViewer : public QWidget {
   public:
-    BackgroundViewer(nba::CoreBase* core, QWidget* parent = nullptr);
+    BackgroundViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
    ~BackgroundViewer() override; 
 
     void SetBackgroundID(int id);
@@ -31,11 +31,11 @@ class BackgroundViewer : public QWidget {
     QLayout* CreateInfoPanel();
     QWidget* CreateCanvasScrollArea();
 
-    void DrawBackgroundMode0();
-    void DrawBackgroundMode2();
-    void DrawBackgroundMode3();
-    void DrawBackgroundMode4();
-    void DrawBackgroundMode5();
+    bool DrawBackgroundMode0(nba::PPUSnapshot const& snapshot, bool redraw_all);
+    bool DrawBackgroundMode2(nba::PPUSnapshot const& snapshot, bool redraw_all);
+    bool DrawBackgroundMode3(nba::PPUSnapshot const& snapshot, bool redraw_all);
+    bool DrawBackgroundMode4(nba::PPUSnapshot const& snapshot, bool redraw_all);
+    bool DrawBackgroundMode5(nba::PPUSnapshot const& snapshot, bool redraw_all);
 
     void DrawTileDetail(int tile_x, int tile_y);
     void ClearTileSelection();
@@ -87,9 +87,13 @@ class BackgroundViewer : public QWidget {
       int palette;
     } m_tile_meta_data[128][128];
 
-    nba::CoreBase* m_core;
-    u16* m_pram;
-    u8*  m_vram;
+    nba::PPUSnapshotMailbox* m_snapshots;
+
+    // The snapshot and registers that the image was last drawn with.
+    bool m_image_valid = false;
+    u64 m_drawn_sequence;
+    u16 m_drawn_dispcnt;
+    u16 m_drawn_bgcnt;
 
     Q_OBJECT
 };
\ No newline at end of file
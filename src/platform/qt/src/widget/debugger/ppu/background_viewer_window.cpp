@@ -9,11 +9,11 @@
 
 #include "background_viewer_window.hpp"
 
-BackgroundViewerWindow::BackgroundViewerWindow(nba::CoreBase* core, QWidget* parent) : QDialog(parent) {
+BackgroundViewerWindow::BackgroundViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QDialog(parent), m_snapshots(snapshots) {
   m_tab_widget = new QTabWidget{};
 
   for(int id = 0; id < 4; id++) {
-    const auto bg_viewer = new BackgroundViewer{core};
+    const auto bg_viewer = new BackgroundViewer{snapshots};
     
     bg_viewer->SetBackgroundID(id);
     m_tab_widget->addTab(bg_viewer, QStringLiteral("BG%1").arg(id));
@@ -31,4 +31,14 @@ void BackgroundViewerWindow::Update() {
   if(isVisible()) {
     m_bg_viewers[m_tab_widget->currentIndex()]->Update();
   }
-}
\ No newline at end of file
+}
+
+void BackgroundViewerWindow::showEvent(QShowEvent* event) {
+  m_snapshots->Subscribe();
+  QDialog::showEvent(event);
+}
+
+void BackgroundViewerWindow::hideEvent(QHideEvent* event) {
+  m_snapshots->Unsubscribe();
+  QDialog::hideEvent(event);
+}
@@ -7,20 +7,27 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QDialog>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QTabWidget>
 
 #include "background_viewer.hpp"
 
 class BackgroundViewerWindow : public QDialog {
   public:
-    BackgroundViewerWindow(nba::CoreBase* core, QWidget* parent = nullptr);
+    BackgroundViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
   public slots:
     void Update();
 
+  protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
   private:
+    nba::PPUSnapshotMailbox* m_snapshots;
     QTabWidget* m_tab_widget;
     BackgroundViewer* m_bg_viewers[4];
 
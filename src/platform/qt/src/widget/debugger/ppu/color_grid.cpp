@@ -26,7 +26,7 @@ ColorGrid::~ColorGrid() {
   delete[] m_buffer_argb8888;
 }
 
-void ColorGrid::Draw(u16* buffer_rgb565, int stride) {
+void ColorGrid::Draw(u16 const* buffer_rgb565, int stride) {
   int i = 0;
 
   for(int y = 0; y < m_rows; y++) {
@@ -17,7 +17,7 @@ class ColorGrid : public QWidget {
     ColorGrid(int rows, int columns, QWidget* parent = nullptr);
    ~ColorGrid() override; 
 
-    void Draw(u16* buffer_rgb565, int stride);
+    void Draw(u16 const* buffer_rgb565, int stride);
     void SetHighlightedPosition(int x, int y);
     void ClearHighlight();
     u32  GetColorAt(int x, int y);
@@ -6,6 +6,7 @@
  */
 
 #include <fmt/format.h>
+#include <nba/common/punning.hpp>
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
@@ -15,15 +16,13 @@
 #include "widget/debugger/utility.hpp"
 #include "palette_viewer.hpp"
 
-PaletteViewer::PaletteViewer(nba::CoreBase* core, QWidget* parent) : QWidget(parent) {
+PaletteViewer::PaletteViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QWidget(parent), m_snapshots(snapshots) {
   QVBoxLayout* vbox = new QVBoxLayout{};
 
   vbox->addWidget(new QLabel{tr("Select a color for detailed information:")});
   vbox->addLayout(CreatePaletteGrids());
   vbox->addLayout(CreateColorInfoArea());
   setLayout(vbox);
-
-  m_pram = (u16*)core->GetPRAM();
 }
 
 QLayout* PaletteViewer::CreatePaletteGrids() {
@@ -87,15 +86,17 @@ void PaletteViewer::Update() {
     return;
   }
 
-  m_palette_color_grids[0]->Draw(&m_pram[0], 16);
-  m_palette_color_grids[1]->Draw(&m_pram[256], 16);
+  const u16* pram = (u16 const*)m_snapshots->Acquire().pram;
+
+  m_palette_color_grids[0]->Draw(&pram[0], 16);
+  m_palette_color_grids[1]->Draw(&pram[256], 16);
 }
 
 void PaletteViewer::ShowColorInfo(int color_index) {
   const u32 address = 0x05000000 + (color_index << 1);
   const int x = color_index & 15;
   const int y = (color_index >> 4) & 15;
-  const u16 color = m_pram[color_index];
+  const u16 color = nba::read<u16>(m_snapshots->Acquire().pram, color_index << 1);
 
   const int r =  (color << 1) & 62;
   const int g = ((color >> 4) & 62) | (color >> 15);
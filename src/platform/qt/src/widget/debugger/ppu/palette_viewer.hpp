@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QDialog>
 #include <QLabel>
 
@@ -15,7 +15,7 @@
 
 class PaletteViewer : public QWidget {
   public:
-    PaletteViewer(nba::CoreBase* core, QWidget* parent = nullptr);
+    PaletteViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
     void Update();
 
@@ -25,7 +25,7 @@ class PaletteViewer : public QWidget {
 
     void ShowColorInfo(int color_index);
 
-    u16* m_pram;
+    nba::PPUSnapshotMailbox* m_snapshots;
     ColorGrid* m_palette_color_grids[2];
     QLabel* m_label_color_address;
     QLabel* m_label_color_r_component;
@@ -10,10 +10,10 @@
 
 #include "palette_viewer_window.hpp"
 
-PaletteViewerWindow::PaletteViewerWindow(nba::CoreBase* core, QWidget* parent) : QDialog(parent) {
+PaletteViewerWindow::PaletteViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QDialog(parent), m_snapshots(snapshots) {
   const auto vbox = new QVBoxLayout{};
 
-  m_palette_viewer = new PaletteViewer{core};
+  m_palette_viewer = new PaletteViewer{snapshots};
   vbox->addWidget(m_palette_viewer);
   vbox->setSizeConstraint(QLayout::SetFixedSize);
 
@@ -25,3 +25,14 @@ PaletteViewerWindow::PaletteViewerWindow(nba::CoreBase* core, QWidget* parent) :
 void PaletteViewerWindow::Update() {
   m_palette_viewer->Update();
 }
+
+// Snapshots of the PPU state are only taken by the emulator thread while a debugger window is shown.
+void PaletteViewerWindow::showEvent(QShowEvent* event) {
+  m_snapshots->Subscribe();
+  QDialog::showEvent(event);
+}
+
+void PaletteViewerWindow::hideEvent(QHideEvent* event) {
+  m_snapshots->Unsubscribe();
+  QDialog::hideEvent(event);
+}
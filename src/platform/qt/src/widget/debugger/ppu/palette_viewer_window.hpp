@@ -7,19 +7,26 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QDialog>
+#include <QHideEvent>
+#include <QShowEvent>
 
 #include "palette_viewer.hpp"
 
 class PaletteViewerWindow : public QDialog {
   public:
-    PaletteViewerWindow(nba::CoreBase* core, QWidget* parent = nullptr);
+    PaletteViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
   public slots:
     void Update();
 
+  protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
   private:
+    nba::PPUSnapshotMailbox* m_snapshots;
     PaletteViewer* m_palette_viewer;
 
     Q_OBJECT
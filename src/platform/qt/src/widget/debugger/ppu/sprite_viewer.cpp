@@ -15,17 +15,13 @@
 #include "widget/debugger/utility.hpp"
 #include "sprite_viewer.hpp"
 
-SpriteViewer::SpriteViewer(nba::CoreBase* core, QWidget* parent) : QWidget{parent}, m_core{core} {
+SpriteViewer::SpriteViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QWidget{parent}, m_snapshots{snapshots} {
   QHBoxLayout* hbox = new QHBoxLayout{};
 
   hbox->addLayout(CreateInfoLayout());
   hbox->addLayout(CreateCanvasLayout());
   hbox->addStretch(1);
   setLayout(hbox);
-
-  m_pram = (u16*)core->GetPRAM();
-  m_vram = core->GetVRAM();
-  m_oam  = core->GetOAM();
 }
 
 QWidget* SpriteViewer::CreateSpriteIndexInput() {
@@ -119,11 +115,40 @@ QLayout* SpriteViewer::CreateCanvasLayout() {
 }
 
 void SpriteViewer::Update() {
-  const int offset = m_spin_sprite_index->value() << 3;
+  const auto& snapshot = m_snapshots->Acquire();
+  const u16* pram = (u16 const*)snapshot.pram;
+
+  const int sprite_index = m_spin_sprite_index->value();
+  const int magnification = m_spin_magnification->value();
+  const int offset = sprite_index << 3;
+
+  /**
+   * Only redraw the sprite if its OAM entry, the sprite palettes, the sprite tiles
+   * or any of the settings changed since it was last drawn.
+   */
+  const bool redraw = !m_image_valid ||
+    m_drawn_sprite_index != sprite_index ||
+    m_drawn_magnification != magnification ||
+    m_drawn_dispcnt != snapshot.dispcnt ||
+    snapshot.OAMChangedSince(m_drawn_sequence, offset, 8) ||
+    snapshot.PRAMChangedSince(m_drawn_sequence, 256 * sizeof(u16), 256 * sizeof(u16)) ||
+    snapshot.VRAMChangedSince(m_drawn_sequence, 0x10000, 0x8000);
+
+  // Either way, the sprite is up-to-date with this snapshot afterwards.
+  m_drawn_sequence = snapshot.sequence;
+
+  if(!redraw) {
+    return;
+  }
+
+  m_image_valid = true;
+  m_drawn_sprite_index = sprite_index;
+  m_drawn_magnification = magnification;
+  m_drawn_dispcnt = snapshot.dispcnt;
 
-  const u16 attr0 = nba::read<u16>(m_oam, offset);
-  const u16 attr1 = nba::read<u16>(m_oam, offset + 2);
-  const u16 attr2 = nba::read<u16>(m_oam, offset + 4);
+  const u16 attr0 = nba::read<u16>(snapshot.oam, offset);
+  const u16 attr1 = nba::read<u16>(snapshot.oam, offset + 2);
+  const u16 attr2 = nba::read<u16>(snapshot.oam, offset + 4);
 
   const int shape = attr0 >> 14;
   const int size  = attr1 >> 14;
@@ -141,7 +166,7 @@ void SpriteViewer::Update() {
   const bool is_8bpp = attr0 & (1 << 13);
   const uint tile_number = attr2 & 0x3FFu;
 
-  const bool one_dimensional_mapping = m_core->PeekHalfIO(0x04000000) & (1 << 6);
+  const bool one_dimensional_mapping = snapshot.dispcnt & (1 << 6);
 
   const int tiles_x = width >> 3;
   const int tiles_y = height >> 3;
@@ -149,7 +174,7 @@ void SpriteViewer::Update() {
   u32* const buffer = (u32*)m_image_rgb32.bits();
 
   if(is_8bpp) {
-    const u16* palette = &m_pram[256];
+    const u16* palette = &pram[256];
 
     for(int tile_y = 0; tile_y < tiles_y; tile_y++) {
       for(int tile_x = 0; tile_x < tiles_x; tile_x++) {
@@ -166,7 +191,7 @@ void SpriteViewer::Update() {
         u32 tile_address = 0x10000u + (current_tile_number << 5);
 
         for(int y = 0; y < 8; y++) {
-          u64 tile_data = nba::read<u64>(m_vram, tile_address);
+          u64 tile_data = nba::read<u64>(snapshot.vram, tile_address);
 
           u32* dst = &buffer[tile_y << 9 | y << 6 | tile_x << 3];
 
@@ -180,7 +205,7 @@ void SpriteViewer::Update() {
       }
     }
   } else {
-    const u16* palette = &m_pram[256 | attr2 >> 12 << 4];
+    const u16* palette = &pram[256 | attr2 >> 12 << 4];
 
     for(int tile_y = 0; tile_y < tiles_y; tile_y++) {
       for(int tile_x = 0; tile_x < tiles_x; tile_x++) {
@@ -197,7 +222,7 @@ void SpriteViewer::Update() {
         u32 tile_address = 0x10000u + (current_tile_number << 5);
 
         for(int y = 0; y < 8; y++) {
-          u32 tile_data = nba::read<u32>(m_vram, tile_address);
+          u32 tile_data = nba::read<u32>(snapshot.vram, tile_address);
 
           u32* dst = &buffer[tile_y << 9 | y << 6 | tile_x << 3];
 
@@ -267,14 +292,13 @@ void SpriteViewer::Update() {
     }
   }
 
-  const int available_render_cycles = (m_core->PeekHalfIO(0x04000000) & (1 << 5)) ? 964 : 1232;
+  const int available_render_cycles = (snapshot.dispcnt & (1 << 5)) ? 964 : 1232;
 
   m_label_sprite_render_cycles->setText(QString::fromStdString(fmt::format("{} ({:.2f} %)", render_cycles, 100.0f * (float)render_cycles / available_render_cycles)));
 
   m_sprite_width = width;
   m_sprite_height = height;
 
-  const int magnification = m_spin_magnification->value();
   m_magnified_sprite_width = width * magnification;
   m_magnified_sprite_height = height * magnification;
   m_canvas->setFixedSize(m_magnified_sprite_width, m_magnified_sprite_height);
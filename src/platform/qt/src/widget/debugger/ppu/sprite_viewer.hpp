@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QCheckBox>
 #include <QGroupBox>
 #include <QImage>
@@ -19,7 +19,7 @@
 
 class SpriteViewer : public QWidget {
   public:
-    SpriteViewer(nba::CoreBase* core, QWidget* parent = nullptr);
+    SpriteViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
     void Update();
     bool eventFilter(QObject* object, QEvent* event) override;
@@ -56,10 +56,14 @@ class SpriteViewer : public QWidget {
     int m_magnified_sprite_width = 0;
     int m_magnified_sprite_height = 0;
 
-    nba::CoreBase* m_core;
-    u16* m_pram;
-    u8* m_vram;
-    u8* m_oam;
+    nba::PPUSnapshotMailbox* m_snapshots;
+
+    // The snapshot and settings that the sprite was last drawn with.
+    bool m_image_valid = false;
+    u64 m_drawn_sequence;
+    u16 m_drawn_dispcnt;
+    int m_drawn_sprite_index;
+    int m_drawn_magnification;
 
     Q_OBJECT
 };
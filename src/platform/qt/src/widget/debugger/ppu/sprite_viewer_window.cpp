@@ -9,10 +9,10 @@
 
 #include "sprite_viewer_window.hpp"
 
-SpriteViewerWindow::SpriteViewerWindow(nba::CoreBase* core, QWidget* parent) : QDialog(parent) {
+SpriteViewerWindow::SpriteViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QDialog(parent), m_snapshots(snapshots) {
   QVBoxLayout* vbox = new QVBoxLayout{};
 
-  m_sprite_viewer = new SpriteViewer{core, nullptr};
+  m_sprite_viewer = new SpriteViewer{snapshots, nullptr};
   vbox->addWidget(m_sprite_viewer);
   setLayout(vbox);
 
@@ -24,4 +24,14 @@ void SpriteViewerWindow::Update() {
   if(isVisible()) {
     m_sprite_viewer->Update();
   }
-}
\ No newline at end of file
+}
+
+void SpriteViewerWindow::showEvent(QShowEvent* event) {
+  m_snapshots->Subscribe();
+  QDialog::showEvent(event);
+}
+
+void SpriteViewerWindow::hideEvent(QHideEvent* event) {
+  m_snapshots->Unsubscribe();
+  QDialog::hideEvent(event);
+}
@@ -7,20 +7,27 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QDialog>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QLabel>
 
 #include "sprite_viewer.hpp"
 
 class SpriteViewerWindow : public QDialog {
   public:
-    SpriteViewerWindow(nba::CoreBase* core, QWidget* parent = nullptr);
+    SpriteViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
   public slots:
     void Update();
 
+  protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
   private:
+    nba::PPUSnapshotMailbox* m_snapshots;
     SpriteViewer* m_sprite_viewer;
 
     Q_OBJECT
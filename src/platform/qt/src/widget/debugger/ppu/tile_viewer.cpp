@@ -16,7 +16,7 @@
 
 #include "tile_viewer.hpp"
 
-TileViewer::TileViewer(nba::CoreBase* core, QWidget* parent) : QWidget(parent) {
+TileViewer::TileViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QWidget(parent), m_snapshots(snapshots) {
   QHBoxLayout* hbox = new QHBoxLayout{};
 
   QVBoxLayout* vbox_l = new QVBoxLayout{};
@@ -45,8 +45,6 @@ TileViewer::TileViewer(nba::CoreBase* core, QWidget* parent) : QWidget(parent) {
   vbox_r->addWidget(m_canvas);
   vbox_r->addStretch();
 
-  m_vram = core->GetVRAM();
-  m_pram = (u16*)core->GetPRAM();
   m_image_rgb565 = new u16[256 * 256];
 
   UpdateImpl();
@@ -224,24 +222,51 @@ void TileViewer::Update() {
 }
 
 void TileViewer::UpdateImpl() {
+  const auto& snapshot = m_snapshots->Acquire();
+  const u16* pram = (u16 const*)snapshot.pram;
+
   const int magnification = m_spin_magnification->value();
   const int palette_offset = m_tile_base == 0x10000u ? 256 : 0;
+  const bool eight_bpp = m_check_eight_bpp->isChecked();
+  const int palette_index = m_spin_palette_index->value();
 
   u16* const image_rgb565 = m_image_rgb565; 
   u32* const image_rgb32  = (u32*)m_image_rgb32.bits();
 
+  /**
+   * Only tiles whose data changed since the image was last drawn need to be decoded again.
+   * If the palette or any of the settings changed, all tiles need to be redrawn.
+   */
+  const bool redraw_all = !m_image_valid ||
+    m_drawn_tile_base != m_tile_base ||
+    m_drawn_eight_bpp != eight_bpp ||
+    m_drawn_palette_index != palette_index ||
+    snapshot.PRAMChangedSince(m_drawn_sequence, palette_offset * sizeof(u16), 256 * sizeof(u16));
+
+  const auto must_redraw_tile = [&](u32 tile_address, u32 tile_size) {
+    return redraw_all || snapshot.VRAMChangedSince(m_drawn_sequence, tile_address, tile_size);
+  };
+
+  bool redrawn = false;
   int height = 256;
-  u32 tile_address = m_tile_base;
 
-  if(m_check_eight_bpp->isChecked()) {
-    u16* const palette = &m_pram[palette_offset];
+  if(eight_bpp) {
+    const u16* palette = &pram[palette_offset];
 
     for(int tile = 0; tile < 512; tile++) {
       const int m_tile_base_x = (tile % 32) * 8;
       const int m_tile_base_y = (tile / 32) * 8;
 
+      u32 tile_address = m_tile_base + tile * 64;
+
+      if(!must_redraw_tile(tile_address, 64)) {
+        continue;
+      }
+
+      redrawn = true;
+
       for(int y = 0; y < 8; y++) {
-        u64 tile_row_data = nba::read<u64>(m_vram, tile_address);
+        u64 tile_row_data = nba::read<u64>(snapshot.vram, tile_address);
 
         for(int x = 0; x < 8; x++) {
           const size_t index = (m_tile_base_y + y) * 256 + m_tile_base_x + x;
@@ -258,14 +283,22 @@ void TileViewer::UpdateImpl() {
 
     height /= 2;
   } else {
-    u16* const palette = &m_pram[m_spin_palette_index->value() * 16 + palette_offset];
+    const u16* palette = &pram[palette_index * 16 + palette_offset];
 
     for(int tile = 0; tile < 1024; tile++) {
       const int m_tile_base_x = (tile % 32) * 8;
       const int m_tile_base_y = (tile / 32) * 8;
 
+      u32 tile_address = m_tile_base + tile * 32;
+
+      if(!must_redraw_tile(tile_address, 32)) {
+        continue;
+      }
+
+      redrawn = true;
+
       for(int y = 0; y < 8; y++) {
-        u32 tile_row_data = nba::read<u32>(m_vram, tile_address);
+        u32 tile_row_data = nba::read<u32>(snapshot.vram, tile_address);
 
         for(int x = 0; x < 8; x++) {
           const size_t index = (m_tile_base_y + y) * 256 + m_tile_base_x + x;
@@ -285,6 +318,16 @@ void TileViewer::UpdateImpl() {
     height /= 2;
   }
 
-  m_canvas->setFixedSize(256 * magnification, height * magnification);
-  m_canvas->update();
+  m_image_valid = true;
+  m_drawn_sequence = snapshot.sequence;
+  m_drawn_tile_base = m_tile_base;
+  m_drawn_eight_bpp = eight_bpp;
+  m_drawn_palette_index = palette_index;
+
+  const QSize size{256 * magnification, height * magnification};
+
+  if(redrawn || m_canvas->size() != size) {
+    m_canvas->setFixedSize(size);
+    m_canvas->update();
+  }
 }
\ No newline at end of file
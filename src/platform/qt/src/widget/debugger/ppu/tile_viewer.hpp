@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QCheckBox>
 #include <QLabel>
 #include <QPaintEvent>
@@ -19,7 +19,7 @@
 
 class TileViewer : public QWidget {
   public:
-    TileViewer(nba::CoreBase* core, QWidget* parent = nullptr);
+    TileViewer(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
    ~TileViewer(); 
 
     bool eventFilter(QObject* object, QEvent* event) override;
@@ -55,8 +55,14 @@ class TileViewer : public QWidget {
     int m_selected_tile_x;
     int m_selected_tile_y;
 
-    u8*  m_vram;
-    u16* m_pram;
+    nba::PPUSnapshotMailbox* m_snapshots;
+
+    // The snapshot and settings that the image was last drawn with.
+    bool m_image_valid = false;
+    u64 m_drawn_sequence;
+    u32 m_drawn_tile_base;
+    bool m_drawn_eight_bpp;
+    int m_drawn_palette_index;
 
     Q_OBJECT
 };
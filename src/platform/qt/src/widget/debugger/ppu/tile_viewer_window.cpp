@@ -9,10 +9,10 @@
 
 #include "tile_viewer_window.hpp"
 
-TileViewerWindow::TileViewerWindow(nba::CoreBase* core, QWidget* parent) : QDialog(parent) {
+TileViewerWindow::TileViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent) : QDialog(parent), m_snapshots(snapshots) {
   QVBoxLayout* vbox = new QVBoxLayout{};
 
-  m_tile_viewer = new TileViewer{core, nullptr};
+  m_tile_viewer = new TileViewer{snapshots, nullptr};
   vbox->addWidget(m_tile_viewer);
   setLayout(vbox);
 
@@ -24,4 +24,14 @@ void TileViewerWindow::Update() {
   if(isVisible()) {
     m_tile_viewer->Update();
   }
-}
\ No newline at end of file
+}
+
+void TileViewerWindow::showEvent(QShowEvent* event) {
+  m_snapshots->Subscribe();
+  QDialog::showEvent(event);
+}
+
+void TileViewerWindow::hideEvent(QHideEvent* event) {
+  m_snapshots->Unsubscribe();
+  QDialog::hideEvent(event);
+}
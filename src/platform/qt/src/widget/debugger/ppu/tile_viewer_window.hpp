@@ -7,20 +7,27 @@
 
 #pragma once
 
-#include <nba/core.hpp>
+#include <nba/ppu_snapshot.hpp>
 #include <QDialog>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QLabel>
 
 #include "tile_viewer.hpp"
 
 class TileViewerWindow : public QDialog {
   public:
-    TileViewerWindow(nba::CoreBase* core, QWidget* parent = nullptr);
+    TileViewerWindow(nba::PPUSnapshotMailbox* snapshots, QWidget* parent = nullptr);
 
   public slots:
     void Update();
 
+  protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
   private:
+    nba::PPUSnapshotMailbox* m_snapshots;
     TileViewer* m_tile_viewer;
 
     Q_OBJECT
@@ -66,13 +66,14 @@ MainWindow::MainWindow(
   controller_manager = new ControllerManager(this, config);
   controller_manager->Initialize();
 
-  emu_thread->SetFrameRateCallback([this](float fps) {
-    emit UpdateFrameRate(fps);
+  emu_thread->SetFrameRateCallback([this](float fps, nba::FrameLimiter::Statistics const& stats) {
+    emit UpdateFrameRate(fps, stats.frame_time_p99);
   });
-  connect(this, &MainWindow::UpdateFrameRate, this, [this](int fps) {
+  connect(this, &MainWindow::UpdateFrameRate, this, [this](int fps, float frame_time_p99) {
     if(config->window.show_fps) {
       const float percent = fps / 59.7275f * 100.0f;
-      setWindowTitle(QStringLiteral("%1 (%2 fps | %3%)").arg(base_window_title).arg(fps).arg(percent));
+      setWindowTitle(QStringLiteral("%1 (%2 fps | %3% | p99 %4 ms)")
+        .arg(base_window_title).arg(fps).arg(percent).arg(frame_time_p99, 0, 'f', 2));
     } else {
       setWindowTitle(base_window_title);
     }
@@ -400,7 +401,7 @@ void MainWindow::CreateToolsMenu() {
 
   connect(tools_menu->addAction(tr("Palette Viewer")), &QAction::triggered, [this]() {
     if(!palette_viewer_window) {
-      palette_viewer_window = new PaletteViewerWindow{core_not_thread_safe, this};
+      palette_viewer_window = new PaletteViewerWindow{&core_not_thread_safe->GetPPUSnapshotMailbox(), this};
       connect(screen.get(), &Screen::RequestDraw, palette_viewer_window, &PaletteViewerWindow::Update);
     }
 
@@ -409,7 +410,7 @@ void MainWindow::CreateToolsMenu() {
 
   connect(tools_menu->addAction(tr("Background Viewer")), &QAction::triggered, [this]() {
     if(!background_viewer_window) {
-      background_viewer_window = new BackgroundViewerWindow{core_not_thread_safe, this};
+      background_viewer_window = new BackgroundViewerWindow{&core_not_thread_safe->GetPPUSnapshotMailbox(), this};
       connect(screen.get(), &Screen::RequestDraw, background_viewer_window, &BackgroundViewerWindow::Update);
     }
 
@@ -418,7 +419,7 @@ void MainWindow::CreateToolsMenu() {
 
   connect(tools_menu->addAction(tr("Tile Viewer")), &QAction::triggered, [this]() {
     if(!tile_viewer_window) {
-      tile_viewer_window = new TileViewerWindow{core_not_thread_safe, this};
+      tile_viewer_window = new TileViewerWindow{&core_not_thread_safe->GetPPUSnapshotMailbox(), this};
       connect(screen.get(), &Screen::RequestDraw, tile_viewer_window, &TileViewerWindow::Update);
     }
 
@@ -426,7 +427,7 @@ void MainWindow::CreateToolsMenu() {
   });
 
   connect(tools_menu->addAction(tr("Sprite Viewer")), &QAction::triggered, [this]() {
-    const auto sprite_viewer_window = new SpriteViewerWindow{core_not_thread_safe, this};
+    const auto sprite_viewer_window = new SpriteViewerWindow{&core_not_thread_safe->GetPPUSnapshotMailbox(), this};
     connect(screen.get(), &Screen::RequestDraw, sprite_viewer_window, &SpriteViewerWindow::Update);
     sprite_viewer_window->show();
   });
@@ -843,6 +844,7 @@ void MainWindow::LoadROM(std::u16string const& path) {
   // Reset the core and start the emulation thread.
   // If the emulator is currently paused force-clear the screen.
   core->Reset();
+  emu_thread->SetFrameLimiterMode(config->frame_limiter_mode);
   emu_thread->Start(std::move(core));
 
   UpdateSolarSensorLevel();
@@ -850,10 +852,8 @@ void MainWindow::LoadROM(std::u16string const& path) {
 }
 
 auto MainWindow::LoadState(std::u16string const& path) -> nba::SaveStateLoader::Result {
-  bool was_running = emu_thread->IsRunning();
-  core = emu_thread->Stop();
-
-  auto result = nba::SaveStateLoader::Load(core, path);
+  auto save_state = std::make_unique<nba::SaveState>();
+  auto result = nba::SaveStateLoader::Load(path, *save_state);
 
   QMessageBox box {this};
   box.setIcon(QMessageBox::Critical);
@@ -879,22 +879,24 @@ auto MainWindow::LoadState(std::u16string const& path) -> nba::SaveStateLoader::
       break;
     }
     case nba::SaveStateLoader::Result::Success: {
+      // The state is loaded by the emulator thread in between two subframes.
+      emu_thread->LoadState(std::move(save_state));
       break;
     }
   }
 
-  if(was_running) {
-    emu_thread->Start(std::move(core));
-  }
-
   return result;
 }
 
 auto MainWindow::SaveState(std::u16string const& path) -> nba::SaveStateWriter::Result {
-  bool was_running = emu_thread->IsRunning();
-  core = emu_thread->Stop();
+  // This waits for at most one subframe, since the emulator thread also handles messages while paused.
+  auto save_state = emu_thread->CopyState().get();
 
-  auto result = nba::SaveStateWriter::Write(core, path);
+  if(!save_state) {
+    return nba::SaveStateWriter::Result::CannotWrite;
+  }
+
+  auto result = nba::SaveStateWriter::Write(*save_state, path);
 
   if(result != nba::SaveStateWriter::Result::Success) {
     QMessageBox box {this};
@@ -904,10 +906,6 @@ auto MainWindow::SaveState(std::u16string const& path) -> nba::SaveStateWriter::
     box.exec();
   }
 
-  if(was_running) {
-    emu_thread->Start(std::move(core));
-  }
-
   return result;
 }
 
@@ -43,7 +43,7 @@ struct MainWindow : QMainWindow {
   void LoadROM(std::u16string const& path);
 
 signals:
-  void UpdateFrameRate(int fps);
+  void UpdateFrameRate(int fps, float frame_time_p99);
 
 private slots:
   void FileOpen();
@@ -63,9 +63,21 @@ bool Screen::Initialize() {
 }
 
 void Screen::Draw(u32* buffer) {
+  unchanged_frame_count = 0;
   emit RequestDraw(buffer);
 }
 
+void Screen::DrawUnchanged(u32* buffer) {
+  /**
+   * LCD ghosting blends each frame 50/50 with the previous output,
+   * so the output only converges after drawing the same frame a few more times.
+   */
+  if(config->video.lcd_ghosting && unchanged_frame_count < kGhostingSettleFrames) {
+    unchanged_frame_count++;
+    emit RequestDraw(buffer);
+  }
+}
+
 void Screen::ReloadConfig() {
   context->makeCurrent(this->windowHandle());
   ogl_video_device.ReloadConfig();
@@ -73,7 +85,12 @@ void Screen::ReloadConfig() {
 }
 
 void Screen::OnRequestDraw(u32* buffer) {
-  this->buffer = buffer;
+  /**
+   * The buffer may already be reused by the emulator thread at this point,
+   * so we only use it to tell whether the screen should be cleared.
+   * The frame itself is acquired from the frame mailbox at render time.
+   */
+  have_frame = buffer != nullptr;
   update();
 }
 
@@ -93,9 +110,9 @@ void Screen::Render() {
   context->makeCurrent(this->windowHandle());
   glClear(GL_COLOR_BUFFER_BIT);
 
-  if(buffer) {
+  if(have_frame) {
     ogl_video_device.SetDefaultFBO(context->defaultFramebufferObject());
-    ogl_video_device.Draw(buffer);
+    ogl_video_device.Draw(frame_mailbox.Acquire());
   }
 
   context->swapBuffers(this->windowHandle());
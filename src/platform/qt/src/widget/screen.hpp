@@ -21,6 +21,8 @@ struct Screen : QWidget, nba::VideoDevice {
 
   bool Initialize();
   void Draw(u32* buffer) final;
+  void DrawUnchanged(u32* buffer) final;
+  auto GetFrameMailbox() -> nba::FrameMailbox* final { return &frame_mailbox; }
   void ReloadConfig();
   QPaintEngine* paintEngine() const override { return nullptr; }; // Silence Qt.
 
@@ -39,10 +41,15 @@ private:
   static constexpr int kGBANativeHeight = 160;
   static constexpr float kGBANativeAR = static_cast<float>(kGBANativeWidth) / static_cast<float>(kGBANativeHeight);
 
+  // Number of redraws until the LCD ghosting history matches a repeated frame at 8 bits per channel.
+  static constexpr int kGhostingSettleFrames = 8;
+
   void Render();
   void UpdateViewport();
 
-  u32* buffer = nullptr;
+  bool have_frame = false;
+  int unchanged_frame_count = 0;
+  nba::FrameMailbox frame_mailbox;
   QOpenGLContext* context = nullptr;
   nba::OGLVideoDevice ogl_video_device;
   std::shared_ptr<QtConfig> config;